@@ -10,14 +10,14 @@ void setup() {
 void loop() {
   mg.setCursor(0, 0);
   if ( ! mg.doubleBuffer()) {
-    mg.println("Some text that glitches");
-    mg.println("because double buffer");
-    mg.println("is not enabled");
+    mg.println("Some text drawn while");
+    mg.println("the previous frame is");
+    mg.println("sent to the screen");
     mg.println("==============="); 
   
   } else {
-    mg.println("Some text that is now");
-    mg.println("clean because");
+    mg.println("Some text drawn in a");
+    mg.println("second buffer because");
     mg.println("double buffer is");
     mg.println("enabled");
     mg.println("==============="); 
@@ -27,11 +27,13 @@ void loop() {
 
   delay(7 + rand() % 5);
 
-  // If double buffering is not enabled, the clear operation will modify the
-  // frame buffer while it is sent to the screen. This will create glitches.
+  // If double buffering is not enabled, the clear operation modifies the
+  // frame buffer while it is sent to the screen. To avoid glitches, it clears
+  // each page (8 pixel high row) only once it has been sent, waiting for the
+  // transfer when it catches up with it.
   // With double buffering enabled, drawing oprations will be preformed on
-  // buffer A while buffer B is sent to the screen, which means there will be
-  // no glitch.
+  // buffer A while buffer B is sent to the screen, which means there is
+  // no need to wait, at the cost of another 1KB of RAM.
   mg.clear();
 
   if (mg.pressed(A_BUTTON)) {
@@ -0,0 +1,424 @@
+/**
+ * @file benchmark.cpp
+ * \brief
+ * Micro-benchmarks of the MicroGamer drawing functions, for host builds.
+ *
+ * \details
+ * Each benchmark draws with one function, using one size or clipping case,
+ * repeatedly into the display buffer. The time per call is measured on the
+ * host CPU, so the results are only meaningful when compared with results
+ * from the same computer and compiler.
+ *
+ * The bytes touched by a call are the sizes of the regions of the display
+ * buffer marked as modified by the call, which is what a partial update
+ * would send to the display.
+ *
+ *     benchmark [-f filter] [-m ms] [-o results.csv] [-c baseline.csv [-r %]]
+ *
+ * -f  Only run the benchmarks whose name contains the given text.
+ * -m  Minimum time to run each benchmark for, in milliseconds (default 50).
+ * -o  Write the results to a CSV file.
+ * -c  Compare with results previously written with -o. The exit status is
+ *     1 if a benchmark is slower than in the baseline by more than the
+ *     tolerance.
+ * -r  Tolerance of the comparison, in percent (default 15).
+ */
+
+#include <MicroGamer.h>
+#include <Sprites.h>
+#include <DisplayList.h>
+#include <TileMap.h>
+#include <AssetCache.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ab_logo.c"
+
+// Gives access to the modified region of the display buffer
+class MicroGamerEx : public MicroGamer
+{
+  public:
+    static void clearDirty()
+    {
+      memset(dirtyStart, 0xFF, sizeof(dirtyStart));
+      memset(dirtyEnd, 0, sizeof(dirtyEnd));
+    }
+
+    static uint16_t dirtyBytes()
+    {
+      uint16_t bytes = 0;
+
+      for (uint8_t page = 0; page < HEIGHT / 8; page++) {
+        if (dirtyStart[page] <= dirtyEnd[page]) {
+          bytes += dirtyEnd[page] - dirtyStart[page] + 1;
+        }
+      }
+      return bytes;
+    }
+};
+
+static MicroGamerEx mg;
+
+// 16x16 test images, in drawBitmap() and Sprites formats
+static uint8_t bitmap16[32];
+static uint8_t sprite16[2 + 32];
+static uint8_t mask16[32];
+static uint8_t spritePlusMask16[2 + 64];
+static uint8_t preshifted16[PRESHIFTED_SPRITE_SIZE(16, 16, 1)];
+
+// A hexagon for fillPolygon()
+static const Point hexagon[6] =
+  { { 64, 4 }, { 100, 18 }, { 100, 46 }, { 64, 60 }, { 28, 46 }, { 28, 18 } };
+
+// fillScreenPattern() pattern
+static const uint8_t checker[8] =
+  { 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA };
+
+// A scene of overlapping sprites, drawn directly or from a display list
+static DisplayCommand sceneCommands[16];
+static DisplayList sceneList(mg, sceneCommands, 16);
+
+static void drawScene()
+{
+  mg.fillRect(0, 48, 128, 16);
+  for (uint8_t i = 0; i < 12; i++) {
+    Sprites::drawExternalMask(i * 9, 20 + i * 3, sprite16, mask16, 0, 0);
+  }
+}
+
+static void recordScene()
+{
+  sceneList.fillRect(0, 48, 128, 16);
+  for (uint8_t i = 0; i < 12; i++) {
+    sceneList.drawSprite(i * 9, 20 + i * 3, sprite16, mask16, 0);
+  }
+}
+
+// A cache holding the decompressed logo
+static uint8_t assetPool[256];
+static AssetCache assetCache(assetPool, sizeof(assetPool));
+static uint8_t decompressed[88 * 2];
+
+// A 32x16 tile map of 4 tiles
+static uint8_t tiles8[2 + 4 * 8];
+static uint8_t map32x16[32 * 16];
+static TileMap tileMap(map32x16, 32, 16, tiles8);
+
+static void drawTilesAsSprites(int16_t cameraX, int16_t cameraY)
+{
+  for (int16_t row = cameraY / 8; row <= (cameraY + HEIGHT - 1) / 8; row++) {
+    for (int16_t col = cameraX / 8; col <= (cameraX + WIDTH - 1) / 8; col++) {
+      Sprites::drawOverwrite(col * 8 - cameraX, row * 8 - cameraY, tiles8,
+                             map32x16[row * 32 + col]);
+    }
+  }
+}
+
+static void scrollTileMap()
+{
+  static int16_t cameraX;
+
+  cameraX = cameraX == 100 ? 0 : cameraX + 1;
+  tileMap.setCamera(cameraX, 16);
+  tileMap.update();
+}
+
+static void makeImages()
+{
+  for (uint8_t i = 0; i < 32; i++) {
+    bitmap16[i] = 0x55 ^ (i * 37);
+    mask16[i] = 0xF0 | i;
+  }
+  sprite16[0] = spritePlusMask16[0] = 16;
+  sprite16[1] = spritePlusMask16[1] = 16;
+  memcpy(sprite16 + 2, bitmap16, sizeof(bitmap16));
+  for (uint8_t i = 0; i < 32; i++) {
+    spritePlusMask16[2 + i * 2] = bitmap16[i];
+    spritePlusMask16[3 + i * 2] = mask16[i];
+  }
+  Sprites::preshift(preshifted16, sprite16, mask16, 1);
+  recordScene();
+
+  tiles8[0] = tiles8[1] = 8;
+  memcpy(tiles8 + 2, bitmap16, sizeof(bitmap16));
+  for (uint16_t i = 0; i < sizeof(map32x16); i++) {
+    map32x16[i] = (i * 7 + i / 32) & 3;
+  }
+}
+
+struct Benchmark
+{
+  const char *primitive;
+  const char *variant;
+  void (*draw)();
+};
+
+static const Benchmark benchmarks[] = {
+  { "drawPixel", "onscreen", [] { mg.drawPixel(64, 32); } },
+  { "drawPixel", "offscreen", [] { mg.drawPixel(-1, 70); } },
+  { "drawPixel", "onscreen <WHITE>", [] { mg.drawPixel<WHITE>(64, 32); } },
+
+  { "drawFastVLine", "h8 aligned", [] { mg.drawFastVLine(64, 8, 8); } },
+  { "drawFastVLine", "h8 unaligned", [] { mg.drawFastVLine(64, 3, 8); } },
+  { "drawFastVLine", "h64", [] { mg.drawFastVLine(64, 0, 64); } },
+  { "drawFastVLine", "partial", [] { mg.drawFastVLine(64, -10, 20); } },
+
+  { "drawFastHLine", "w16", [] { mg.drawFastHLine(56, 32, 16); } },
+  { "drawFastHLine", "w128", [] { mg.drawFastHLine(0, 32, 128); } },
+  { "drawFastHLine", "partial", [] { mg.drawFastHLine(-50, 32, 100); } },
+  { "drawFastHLine", "w128 <WHITE>", [] { mg.drawFastHLine<WHITE>(0, 32, 128); } },
+
+  { "fillRect", "16x16 aligned", [] { mg.fillRect(56, 24, 16, 16); } },
+  { "fillRect", "16x16 unaligned", [] { mg.fillRect(56, 27, 16, 16); } },
+  { "fillRect", "128x64", [] { mg.fillRect(0, 0, 128, 64); } },
+  { "fillRect", "partial", [] { mg.fillRect(-8, -8, 16, 16); } },
+
+  { "fillScreen", "", [] { mg.fillScreen(BLACK); } },
+  { "fillScreen", "WHITE", [] { mg.fillScreen(WHITE); } },
+  { "fillScreen", "INVERSE", [] { mg.fillScreen(INVERSE); } },
+  { "fillScreenPattern", "", [] { mg.fillScreenPattern(checker); } },
+
+  { "scroll", "dx 1", [] { mg.scroll(1, 0); } },
+  { "scroll", "dy 1", [] { mg.scroll(0, 1); } },
+  { "scroll", "dy -8", [] { mg.scroll(0, -8); } },
+  { "scroll", "dx -2 dy 3", [] { mg.scroll(-2, 3); } },
+
+  { "drawLine", "shallow", [] { mg.drawLine(0, 20, 127, 40); } },
+  { "drawLine", "steep", [] { mg.drawLine(50, 0, 70, 63); } },
+  { "drawLine", "diagonal", [] { mg.drawLine(0, 0, 63, 63); } },
+  { "drawLine", "partial", [] { mg.drawLine(-100, -20, 200, 90); } },
+  { "drawLine", "long offscreen", [] { mg.drawLine(-3000, -1000, 3000, 1000); } },
+
+  { "fillCircle", "r4", [] { mg.fillCircle(64, 32, 4); } },
+  { "fillCircle", "r16", [] { mg.fillCircle(64, 32, 16); } },
+  { "fillCircle", "r31", [] { mg.fillCircle(64, 32, 31); } },
+  { "fillCircle", "partial", [] { mg.fillCircle(0, 0, 20); } },
+  { "drawCircle", "r4", [] { mg.drawCircle(64, 32, 4); } },
+  { "drawCircle", "r31", [] { mg.drawCircle(64, 32, 31); } },
+  { "drawCircle", "offscreen", [] { mg.drawCircle(-100, 32, 31); } },
+  { "fillEllipse", "40x20", [] { mg.fillEllipse(64, 32, 40, 20); } },
+  { "drawEllipse", "40x20", [] { mg.drawEllipse(64, 32, 40, 20); } },
+
+  { "fillTriangle", "small", [] { mg.fillTriangle(60, 28, 68, 30, 62, 36); } },
+  { "fillTriangle", "large", [] { mg.fillTriangle(0, 0, 127, 20, 30, 63); } },
+  { "fillTriangle", "partial", [] { mg.fillTriangle(-40, -10, 60, 20, 10, 90); } },
+  { "fillPolygon", "hexagon", [] { mg.fillPolygon(hexagon, 6); } },
+
+  { "drawBitmap", "16x16 aligned", [] { mg.drawBitmap(56, 24, bitmap16, 16, 16); } },
+  { "drawBitmap", "16x16 unaligned", [] { mg.drawBitmap(56, 27, bitmap16, 16, 16); } },
+  { "drawBitmap", "88x16 logo", [] { mg.drawBitmap(20, 27, arduboy_logo, 88, 16); } },
+  { "drawBitmap", "partial", [] { mg.drawBitmap(-8, -5, bitmap16, 16, 16); } },
+  { "drawBitmap", "88x16 logo INVERT", [] { mg.drawBitmap(20, 27, arduboy_logo, 88, 16, INVERT); } },
+  { "drawBitmap", "88x16 logo <INVERT>", [] { mg.drawBitmap<INVERT>(20, 27, arduboy_logo, 88, 16); } },
+
+  { "drawCompressed", "logo aligned", [] { mg.drawCompressed(20, 24, arduboy_logo_compressed); } },
+  { "drawCompressed", "logo unaligned", [] { mg.drawCompressed(20, 27, arduboy_logo_compressed); } },
+  { "drawCompressed", "logo partial", [] { mg.drawCompressed(-40, -5, arduboy_logo_compressed); } },
+  { "drawCompressed", "AssetCache aligned", [] { assetCache.draw(20, 24, arduboy_logo_compressed); } },
+  { "drawCompressed", "AssetCache unaligned", [] { assetCache.draw(20, 27, arduboy_logo_compressed); } },
+  { "drawCompressed", "decompress", [] { mg.decompress(decompressed, arduboy_logo_compressed); } },
+
+  { "drawChar", "size 1 aligned", [] { mg.drawChar(60, 24, 'A', WHITE, BLACK, 1); } },
+  { "drawChar", "size 1 unaligned", [] { mg.drawChar(60, 27, 'A', WHITE, BLACK, 1); } },
+  { "drawChar", "size 1 transparent", [] { mg.drawChar(60, 27, 'A', WHITE, WHITE, 1); } },
+  { "drawChar", "size 2", [] { mg.drawChar(60, 24, 'A', WHITE, BLACK, 2); } },
+
+  { "Sprites::drawOverwrite", "16x16 aligned", [] { Sprites::drawOverwrite(56, 24, sprite16, 0); } },
+  { "Sprites::drawOverwrite", "16x16 unaligned", [] { Sprites::drawOverwrite(56, 27, sprite16, 0); } },
+  { "Sprites::drawOverwrite", "partial", [] { Sprites::drawOverwrite(-8, -5, sprite16, 0); } },
+  { "Sprites::drawSelfMasked", "16x16 unaligned", [] { Sprites::drawSelfMasked(56, 27, sprite16, 0); } },
+  { "Sprites::drawSelfMasked", "88x16 logo", [] { Sprites::drawSelfMasked(20, 27, arduboy_logo_sprite, 0); } },
+  { "Sprites::drawErase", "16x16 unaligned", [] { Sprites::drawErase(56, 27, sprite16, 0); } },
+  { "Sprites::drawExternalMask", "16x16 aligned", [] { Sprites::drawExternalMask(56, 24, sprite16, mask16, 0, 0); } },
+  { "Sprites::drawExternalMask", "16x16 unaligned", [] { Sprites::drawExternalMask(56, 27, sprite16, mask16, 0, 0); } },
+  { "Sprites::drawPlusMask", "16x16 aligned", [] { Sprites::drawPlusMask(56, 24, spritePlusMask16, 0); } },
+  { "Sprites::drawPlusMask", "16x16 unaligned", [] { Sprites::drawPlusMask(56, 27, spritePlusMask16, 0); } },
+  { "Sprites::drawPlusMask", "partial", [] { Sprites::drawPlusMask(-8, -5, spritePlusMask16, 0); } },
+  { "Sprites::drawPreshifted", "16x16 aligned", [] { Sprites::drawPreshifted(56, 24, preshifted16, 0); } },
+  { "Sprites::drawPreshifted", "16x16 unaligned", [] { Sprites::drawPreshifted(56, 27, preshifted16, 0); } },
+
+  { "tiles", "Sprites aligned", [] { drawTilesAsSprites(40, 16); } },
+  { "tiles", "Sprites unaligned", [] { drawTilesAsSprites(43, 19); } },
+  { "tiles", "TileMap aligned", [] { tileMap.setCamera(40, 16); tileMap.draw(); } },
+  { "tiles", "TileMap unaligned", [] { tileMap.setCamera(43, 19); tileMap.draw(); } },
+  { "tiles", "TileMap scroll", scrollTileMap },
+
+  { "clip", "fillRect aligned", [] { mg.pushClip(Rect{40, 16, 48, 32}); mg.fillRect(0, 0, 128, 64); mg.popClip(); } },
+  { "clip", "fillRect unaligned", [] { mg.pushClip(Rect{40, 19, 48, 29}); mg.fillRect(0, 0, 128, 64); mg.popClip(); } },
+  { "clip", "drawBitmap unaligned", [] { mg.pushClip(Rect{40, 19, 48, 29}); mg.drawBitmap(20, 27, arduboy_logo, 88, 16); mg.popClip(); } },
+  { "clip", "Sprites unaligned", [] { mg.pushClip(Rect{40, 19, 48, 29}); Sprites::drawPlusMask(56, 27, spritePlusMask16, 0); mg.popClip(); } },
+  { "clip", "viewport scene", [] { mg.pushViewport(Rect{16, 8, 96, 48}); drawScene(); mg.popClip(); } },
+
+  { "scene", "direct", drawScene },
+  { "scene", "DisplayList::render", [] { sceneList.render(); } },
+  { "scene", "record and render", [] { sceneList.clear(); recordScene(); sceneList.render(); } },
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+struct Result
+{
+  double nsPerOp;
+  uint16_t bytes;
+  unsigned long iterations;
+};
+
+static uint64_t nowNs()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static Result run(const Benchmark &b, unsigned long minMs)
+{
+  Result r;
+
+  mg.clear();
+  mg.clearDirty();
+  b.draw();
+  r.bytes = mg.dirtyBytes();
+
+  // calibrate, then measure
+  unsigned long count = 16;
+  uint64_t elapsed;
+  for (;;) {
+    uint64_t start = nowNs();
+    for (unsigned long i = 0; i < count; i++) {
+      b.draw();
+    }
+    elapsed = nowNs() - start;
+    if (elapsed >= minMs * 1000000ULL) {
+      break;
+    }
+    count *= elapsed < minMs * 100000ULL ? 10 : 2;
+  }
+
+  r.nsPerOp = (double)elapsed / count;
+  r.iterations = count;
+  return r;
+}
+
+// Find the time per call of a benchmark in a CSV file written with -o.
+// Returns a negative value if not found.
+static double baselineNs(FILE *f, const Benchmark &b)
+{
+  char line[256];
+
+  rewind(f);
+  while (fgets(line, sizeof(line), f) != NULL) {
+    // strtok() would skip an empty variant field
+    char *primitive = line;
+    char *variant = strchr(primitive, ',');
+    char *ns = variant != NULL ? strchr(variant + 1, ',') : NULL;
+    if (ns == NULL) {
+      continue;
+    }
+    *variant++ = '\0';
+    *ns++ = '\0';
+    if (strcmp(primitive, b.primitive) == 0 &&
+        strcmp(variant, b.variant) == 0) {
+      return atof(ns);
+    }
+  }
+  return -1;
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [-f filter] [-m ms] [-o results.csv] "
+                  "[-c baseline.csv [-r %%]]\n", name);
+}
+
+int main(int argc, char **argv)
+{
+  const char *filter = NULL;
+  const char *outFile = NULL;
+  const char *baselineFile = NULL;
+  unsigned long minMs = 50;
+  double tolerance = 15;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "f:m:o:c:r:")) != -1) {
+    switch (opt) {
+      case 'f': filter = optarg; break;
+      case 'm': minMs = strtoul(optarg, NULL, 0); break;
+      case 'o': outFile = optarg; break;
+      case 'c': baselineFile = optarg; break;
+      case 'r': tolerance = atof(optarg); break;
+      default:
+        usage(argv[0]);
+        return 2;
+    }
+  }
+
+  FILE *out = NULL;
+  if (outFile != NULL) {
+    out = fopen(outFile, "w");
+    if (out == NULL) {
+      perror(outFile);
+      return 2;
+    }
+    fprintf(out, "primitive,case,ns_per_op,bytes_touched,iterations\n");
+  }
+
+  FILE *baseline = NULL;
+  if (baselineFile != NULL) {
+    baseline = fopen(baselineFile, "r");
+    if (baseline == NULL) {
+      perror(baselineFile);
+      return 2;
+    }
+  }
+
+  mg.begin();
+  makeImages();
+
+  int regressions = 0;
+  printf("%-28s %-20s %10s %6s%s\n", "primitive", "case", "ns/op", "bytes",
+         baseline != NULL ? "   change" : "");
+
+  for (unsigned int i = 0; i < BENCHMARK_COUNT; i++) {
+    const Benchmark &b = benchmarks[i];
+    char name[128];
+
+    snprintf(name, sizeof(name), "%s %s", b.primitive, b.variant);
+    if (filter != NULL && strstr(name, filter) == NULL) {
+      continue;
+    }
+
+    Result r = run(b, minMs);
+    printf("%-28s %-20s %10.1f %6u", b.primitive, b.variant, r.nsPerOp,
+           r.bytes);
+
+    if (baseline != NULL) {
+      double base = baselineNs(baseline, b);
+      if (base > 0) {
+        double change = 100.0 * (r.nsPerOp - base) / base;
+        printf(" %+7.1f%%", change);
+        if (change > tolerance) {
+          printf(" SLOWER");
+          regressions++;
+        }
+      }
+    }
+    printf("\n");
+
+    if (out != NULL) {
+      fprintf(out, "%s,%s,%.2f,%u,%lu\n", b.primitive, b.variant, r.nsPerOp,
+              r.bytes, r.iterations);
+    }
+  }
+
+  if (out != NULL) {
+    fclose(out);
+  }
+  if (baseline != NULL) {
+    fclose(baseline);
+    printf("%d regression(s) above %.0f%%\n", regressions, tolerance);
+  }
+
+  return regressions != 0;
+}
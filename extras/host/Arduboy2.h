@@ -0,0 +1,16 @@
+/**
+ * @file Arduboy2.h
+ * \brief
+ * Compatibility names for the example sketches which are still written for
+ * the Arduboy2 library, for host builds.
+ */
+
+#ifndef MICROGAMER_HOST_ARDUBOY2_H
+#define MICROGAMER_HOST_ARDUBOY2_H
+
+#include <MicroGamer.h>
+
+typedef MicroGamerBase Arduboy2Base;
+typedef MicroGamer Arduboy2;
+
+#endif
@@ -0,0 +1,667 @@
+/**
+ * @file MicroGamerHost.cpp
+ * \brief
+ * Software models of the MicroGamer hardware, for host builds.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <MicroGamerCore.h>
+#include "MicroGamerHost.h"
+
+// I2C timing at 400 kHz: 9 clocks per byte (8 bits and the acknowledge)
+#define TWI_BIT_NS 2500ULL
+#define TWI_BYTE_NS (9 * TWI_BIT_NS)
+
+// Simulated CPU frequency, for the timer model
+#define CPU_HZ 16000000ULL
+
+#define NO_EVENT UINT64_MAX
+
+SSD1306Model MicroGamerHost::display;
+uint32_t MicroGamerHost::busBytes = 0;
+uint64_t MicroGamerHost::busTimeNs = 0;
+
+NRF_TWI_Type hostTwi1;
+NRF_TIMER_Type hostTimer2;
+NRF_NVMC_Type hostNvmc;
+TwoWire Wire;
+
+static uint64_t clockNs = 0;
+
+static bool irqMasked = false;
+static bool inHandler = false;
+static bool twiIrqEnabled = false;
+static bool timerIrqEnabled = false;
+
+static uint8_t pinLevel[32];
+
+//========================================
+//========== SSD1306 controller ==========
+//========================================
+
+SSD1306Model::SSD1306Model()
+{
+  reset();
+}
+
+void SSD1306Model::reset()
+{
+  memset(ram, 0, sizeof(ram));
+  displayOn = false;
+  entireDisplayOn = false;
+  inverse = false;
+  segmentRemap = false;
+  comScanDecrement = false;
+  contrast = 0x7F;
+  startLine = 0;
+  displayOffset = 0;
+  memoryMode = 2;
+  columnStart = 0;
+  columnEnd = 127;
+  pageStart = 0;
+  pageEnd = 7;
+  column = 0;
+  page = 0;
+  scrollActive = false;
+  memset(scrollSetup, 0, sizeof(scrollSetup));
+  verticalScrollArea[0] = 0;
+  verticalScrollArea[1] = 64;
+  addressed = false;
+  cmdLength = 0;
+  cmdExpected = 0;
+  resetStats();
+}
+
+void SSD1306Model::resetStats()
+{
+  transactions = 0;
+  commandBytes = 0;
+  dataBytes = 0;
+  controlBytes = 0;
+  memset(pixelWrites, 0, sizeof(pixelWrites));
+}
+
+uint8_t SSD1306Model::panelPixel(uint8_t x, uint8_t y) const
+{
+  if (!displayOn) {
+    return 0;
+  }
+  if (entireDisplayOn) {
+    return 1;
+  }
+
+  uint8_t com = comScanDecrement ? 63 - y : y;
+  uint8_t row = (com + startLine + displayOffset) & 63;
+  uint8_t seg = segmentRemap ? 127 - x : x;
+  uint8_t on = (ram[row / 8][seg] >> (row & 7)) & 1;
+
+  return inverse ? !on : on;
+}
+
+bool SSD1306Model::writePBM(const char *fileName) const
+{
+  FILE *f = fopen(fileName, "wb");
+
+  if (f == NULL) {
+    return false;
+  }
+
+  fprintf(f, "P4\n128 64\n");
+  for (uint8_t y = 0; y < 64; y++) {
+    for (uint8_t x = 0; x < 128; x += 8) {
+      uint8_t b = 0;
+      for (uint8_t i = 0; i < 8; i++) {
+        b = (b << 1) | panelPixel(x + i, y);
+      }
+      fputc(b, f);
+    }
+  }
+
+  return fclose(f) == 0;
+}
+
+void SSD1306Model::beginTransaction(uint8_t address)
+{
+  addressed = (address == 0x3C);
+  expectControl = true;
+  if (addressed) {
+    transactions++;
+  }
+}
+
+void SSD1306Model::receive(uint8_t b)
+{
+  if (!addressed) {
+    return;
+  }
+
+  if (expectControl) {
+    // Co (bit 7) = 1: a single byte follows, then another control byte
+    // D/C (bit 6) = 1: data, 0: commands
+    controlBytes++;
+    continuation = (b & 0x80) != 0;
+    dataMode = (b & 0x40) != 0;
+    expectControl = false;
+    return;
+  }
+
+  if (dataMode) {
+    data(b);
+  } else {
+    command(b);
+  }
+
+  if (continuation) {
+    expectControl = true;
+  }
+}
+
+void SSD1306Model::endTransaction()
+{
+  addressed = false;
+}
+
+// Number of argument bytes following a command byte
+static uint8_t commandArguments(uint8_t c)
+{
+  switch (c) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+    case 0x21: case 0x22: case 0xA3:
+      return 2;
+    case 0x29: case 0x2A:
+      return 5;
+    case 0x26: case 0x27:
+      return 6;
+    default:
+      return 0;
+  }
+}
+
+void SSD1306Model::command(uint8_t b)
+{
+  commandBytes++;
+
+  if (cmdLength == 0) {
+    cmdExpected = commandArguments(b);
+  }
+  cmd[cmdLength++] = b;
+  if (cmdLength <= cmdExpected) {
+    return;
+  }
+  cmdLength = 0;
+
+  uint8_t c = cmd[0];
+
+  if (c <= 0x0F) {
+    column = (column & 0xF0) | c;
+  } else if (c <= 0x1F) {
+    column = ((c & 0x07) << 4) | (column & 0x0F);
+  } else if (c >= 0x40 && c <= 0x7F) {
+    startLine = c & 0x3F;
+  } else if (c >= 0xB0 && c <= 0xB7) {
+    page = c & 0x07;
+  } else {
+    switch (c) {
+      case 0x20: memoryMode = cmd[1] & 0x03; break;
+      case 0x21:
+        columnStart = column = cmd[1] & 0x7F;
+        columnEnd = cmd[2] & 0x7F;
+        break;
+      case 0x22:
+        pageStart = page = cmd[1] & 0x07;
+        pageEnd = cmd[2] & 0x07;
+        break;
+      case 0x26: case 0x27: case 0x29: case 0x2A:
+        memcpy(scrollSetup, cmd, cmdExpected + 1);
+        break;
+      case 0x2E: scrollActive = false; break;
+      case 0x2F: scrollActive = true; break;
+      case 0x81: contrast = cmd[1]; break;
+      case 0xA0: segmentRemap = false; break;
+      case 0xA1: segmentRemap = true; break;
+      case 0xA3:
+        verticalScrollArea[0] = cmd[1] & 0x3F;
+        verticalScrollArea[1] = cmd[2] & 0x7F;
+        break;
+      case 0xA4: entireDisplayOn = false; break;
+      case 0xA5: entireDisplayOn = true; break;
+      case 0xA6: inverse = false; break;
+      case 0xA7: inverse = true; break;
+      case 0xAE: displayOn = false; break;
+      case 0xAF: displayOn = true; break;
+      case 0xC0: comScanDecrement = false; break;
+      case 0xC8: comScanDecrement = true; break;
+      case 0xD3: displayOffset = cmd[1] & 0x3F; break;
+      default: break;
+    }
+  }
+}
+
+void SSD1306Model::data(uint8_t b)
+{
+  dataBytes++;
+  ram[page][column] = b;
+  pixelWrites[page][column]++;
+
+  switch (memoryMode) {
+    case 0: // horizontal
+      if (column++ >= columnEnd) {
+        column = columnStart;
+        if (page++ >= pageEnd) {
+          page = pageStart;
+        }
+      }
+      break;
+
+    case 1: // vertical
+      if (page++ >= pageEnd) {
+        page = pageStart;
+        if (column++ >= columnEnd) {
+          column = columnStart;
+        }
+      }
+      break;
+
+    default: // page
+      if (column < 127) {
+        column++;
+      }
+      break;
+  }
+}
+
+//====================================
+//========== TWI peripheral ==========
+//====================================
+
+static bool twiTransaction = false;  // a START has been sent
+static bool twiAddressSent = false;
+static uint64_t twiBusFreeNs = 0;    // end of the last byte or condition
+static uint64_t twiByteDoneNs = NO_EVENT;
+static uint8_t twiByte;
+static uint64_t twiStopDoneNs = NO_EVENT;
+
+static void deliverInterrupts();
+
+static void twiBusy(uint64_t start, uint64_t duration)
+{
+  MicroGamerHost::busTimeNs += duration;
+  twiBusFreeNs = start + duration;
+}
+
+static void twiStartTx(HostRegister &reg, uint32_t value)
+{
+  reg.value = value;
+  if (value) {
+    twiTransaction = true;
+    twiAddressSent = false;
+  }
+}
+
+static void twiTxd(HostRegister &reg, uint32_t value)
+{
+  reg.value = value & 0xFF;
+  if (!twiTransaction) {
+    return;
+  }
+
+  uint64_t start = max(clockNs, twiBusFreeNs);
+  if (twiByteDoneNs != NO_EVENT) {
+    // the previous byte is still being sent, this one follows it
+    start = max(start, twiByteDoneNs);
+  }
+
+  uint64_t duration = TWI_BYTE_NS;
+  if (!twiAddressSent) {
+    // START condition and address byte
+    twiAddressSent = true;
+    duration += TWI_BIT_NS + TWI_BYTE_NS;
+    MicroGamerHost::busBytes++;
+    MicroGamerHost::display.beginTransaction(hostTwi1.ADDRESS.value);
+  }
+
+  MicroGamerHost::busBytes++;
+  twiBusy(start, duration);
+  twiByte = value;
+  twiByteDoneNs = twiBusFreeNs;
+}
+
+static void twiStop(HostRegister &reg, uint32_t value)
+{
+  reg.value = value;
+  if (!value || !twiTransaction) {
+    return;
+  }
+
+  uint64_t start = max(clockNs, twiBusFreeNs);
+  if (twiByteDoneNs != NO_EVENT) {
+    start = max(start, twiByteDoneNs);
+  }
+  twiBusy(start, TWI_BIT_NS);
+  twiStopDoneNs = twiBusFreeNs;
+  twiTransaction = false;
+}
+
+static void twiIntenSet(HostRegister &reg, uint32_t value)
+{
+  (void)reg;
+  hostTwi1.INTEN.value |= value;
+}
+
+static void twiIntenClr(HostRegister &reg, uint32_t value)
+{
+  (void)reg;
+  hostTwi1.INTEN.value &= ~value;
+}
+
+// Polling an event which hasn't happened yet lets the time pass until the
+// next peripheral event.
+static uint32_t readEvent(HostRegister &reg)
+{
+  if (reg.value == 0 && !inHandler) {
+    MicroGamerHost::runNextEvent();
+  }
+  return reg.value;
+}
+
+static uint64_t twiNextEvent()
+{
+  return min(twiByteDoneNs, twiStopDoneNs);
+}
+
+static void twiRunEvent(uint64_t now)
+{
+  if (twiByteDoneNs == now) {
+    twiByteDoneNs = NO_EVENT;
+    MicroGamerHost::display.receive(twiByte);
+    hostTwi1.EVENTS_TXDSENT.value = 1;
+  }
+  if (twiStopDoneNs == now) {
+    twiStopDoneNs = NO_EVENT;
+    MicroGamerHost::display.endTransaction();
+    hostTwi1.EVENTS_STOPPED.value = 1;
+  }
+}
+
+static bool twiInterruptPending()
+{
+  uint32_t pending = 0;
+
+  if (hostTwi1.EVENTS_STOPPED.value)  pending |= 1UL << TWI_INTENSET_STOPPED_Pos;
+  if (hostTwi1.EVENTS_RXDREADY.value) pending |= 1UL << TWI_INTENSET_RXDREADY_Pos;
+  if (hostTwi1.EVENTS_TXDSENT.value)  pending |= 1UL << TWI_INTENSET_TXDSENT_Pos;
+  if (hostTwi1.EVENTS_ERROR.value)    pending |= 1UL << TWI_INTENSET_ERROR_Pos;
+
+  return twiIrqEnabled && (pending & hostTwi1.INTEN.value) != 0;
+}
+
+//===========================
+//========== Timer ==========
+//===========================
+
+static bool timerRunning = false;
+static uint64_t timerCompareNs = NO_EVENT;
+
+static uint64_t timerPeriodNs()
+{
+  uint64_t ticks = hostTimer2.CC[0].value ? hostTimer2.CC[0].value : 1;
+  return ticks * (1ULL << (hostTimer2.PRESCALER.value & 0x0F)) *
+         1000000000ULL / CPU_HZ;
+}
+
+static void timerStart(HostRegister &reg, uint32_t value)
+{
+  reg.value = value;
+  if (value) {
+    timerRunning = true;
+    timerCompareNs = clockNs + timerPeriodNs();
+  }
+}
+
+static void timerStop(HostRegister &reg, uint32_t value)
+{
+  reg.value = value;
+  if (value) {
+    timerRunning = false;
+    timerCompareNs = NO_EVENT;
+  }
+}
+
+static void timerClear(HostRegister &reg, uint32_t value)
+{
+  reg.value = value;
+  if (value && timerRunning) {
+    timerCompareNs = clockNs + timerPeriodNs();
+  }
+}
+
+static void timerRunEvent(uint64_t now)
+{
+  if (timerCompareNs == now) {
+    hostTimer2.EVENTS_COMPARE[0].value = 1;
+    timerCompareNs = now + timerPeriodNs();
+  }
+}
+
+//==============================================
+//========== Interrupts and the clock ==========
+//==============================================
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+  if (irq == SPI1_TWI1_IRQn) {
+    twiIrqEnabled = true;
+  } else if (irq == TIMER2_IRQn) {
+    timerIrqEnabled = true;
+  }
+  deliverInterrupts();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+  if (irq == SPI1_TWI1_IRQn) {
+    twiIrqEnabled = false;
+  } else if (irq == TIMER2_IRQn) {
+    timerIrqEnabled = false;
+  }
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+  (void)irq;
+}
+
+void __disable_irq()
+{
+  irqMasked = true;
+}
+
+void __enable_irq()
+{
+  irqMasked = false;
+  deliverInterrupts();
+}
+
+static void deliverInterrupts()
+{
+  if (irqMasked || inHandler) {
+    return;
+  }
+
+  inHandler = true;
+  for (uint8_t i = 0; i < 16; i++) {
+    if (twiInterruptPending()) {
+      SPI1_TWI1_IRQHandler();
+    } else if (timerIrqEnabled && hostTimer2.EVENTS_COMPARE[0].value) {
+      TIMER2_IRQHandler();
+    } else {
+      break;
+    }
+  }
+  inHandler = false;
+}
+
+uint64_t MicroGamerHost::nanos()
+{
+  return clockNs;
+}
+
+bool MicroGamerHost::runNextEvent()
+{
+  uint64_t next = min(twiNextEvent(), timerCompareNs);
+
+  if (next == NO_EVENT) {
+    return false;
+  }
+
+  clockNs = max(clockNs, next);
+  twiRunEvent(next);
+  timerRunEvent(next);
+  deliverInterrupts();
+  return true;
+}
+
+void MicroGamerHost::advance(uint64_t ns)
+{
+  uint64_t end = clockNs + ns;
+
+  while (min(twiNextEvent(), timerCompareNs) <= end) {
+    runNextEvent();
+  }
+  clockNs = end;
+}
+
+void MicroGamerHost::flush()
+{
+  while (twiNextEvent() != NO_EVENT) {
+    runNextEvent();
+  }
+}
+
+void MicroGamerHost::setPin(uint8_t pin, uint8_t level)
+{
+  pinLevel[pin & 31] = level;
+}
+
+void MicroGamerHost::setButtons(uint8_t buttons)
+{
+  // the buttons are active low
+  setPin(BUTTON_LEFT_PIN, !(buttons & LEFT_BUTTON));
+  setPin(BUTTON_RIGHT_PIN, !(buttons & RIGHT_BUTTON));
+  setPin(BUTTON_UP_PIN, !(buttons & UP_BUTTON));
+  setPin(BUTTON_DOWN_PIN, !(buttons & DOWN_BUTTON));
+  setPin(BUTTON_Y_PIN, !(buttons & A_BUTTON));
+  setPin(BUTTON_X_PIN, !(buttons & B_BUTTON));
+}
+
+void MicroGamerHost::resetStats()
+{
+  busBytes = 0;
+  busTimeNs = 0;
+  display.resetStats();
+}
+
+//===========================================
+//========== Arduino core and Wire ==========
+//===========================================
+
+void pinMode(uint32_t pin, uint32_t mode)
+{
+  if (mode == INPUT_PULLUP) {
+    pinLevel[pin & 31] = HIGH;
+  }
+}
+
+void digitalWrite(uint32_t pin, uint32_t value)
+{
+  pinLevel[pin & 31] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint32_t pin)
+{
+  return pinLevel[pin & 31];
+}
+
+uint32_t analogRead(uint32_t pin)
+{
+  (void)pin;
+  return 0;
+}
+
+unsigned long millis()
+{
+  return clockNs / 1000000ULL;
+}
+
+unsigned long micros()
+{
+  return clockNs / 1000ULL;
+}
+
+void delay(unsigned long ms)
+{
+  MicroGamerHost::advance(ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  MicroGamerHost::advance(us * 1000ULL);
+}
+
+void yield()
+{
+  // sleep until the next interrupt, or at most a millisecond
+  uint64_t next = min(twiNextEvent(), timerCompareNs);
+  MicroGamerHost::advance(min(next - min(next, clockNs), 1000000ULL));
+}
+
+void randomSeed(unsigned long seed)
+{
+  srand(seed);
+}
+
+long random(long howbig)
+{
+  return howbig > 0 ? rand() % howbig : 0;
+}
+
+long random(long howsmall, long howbig)
+{
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+  (void)clock;
+}
+
+// Install the register handlers before any constructor of the library or
+// the sketch can touch the peripherals.
+__attribute__((constructor(101)))
+static void hostInit()
+{
+  hostTwi1.TASKS_STARTTX.onWrite = twiStartTx;
+  hostTwi1.TASKS_STOP.onWrite = twiStop;
+  hostTwi1.TXD.onWrite = twiTxd;
+  hostTwi1.INTENSET.onWrite = twiIntenSet;
+  hostTwi1.INTENCLR.onWrite = twiIntenClr;
+  hostTwi1.EVENTS_STOPPED.onRead = readEvent;
+  hostTwi1.EVENTS_TXDSENT.onRead = readEvent;
+
+  hostTimer2.TASKS_START.onWrite = timerStart;
+  hostTimer2.TASKS_STOP.onWrite = timerStop;
+  hostTimer2.TASKS_CLEAR.onWrite = timerClear;
+
+  hostNvmc.READY.value = 1;
+
+  for (uint8_t i = 0; i < 32; i++) {
+    pinLevel[i] = HIGH;
+  }
+}
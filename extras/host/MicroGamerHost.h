@@ -0,0 +1,132 @@
+/**
+ * @file MicroGamerHost.h
+ * \brief
+ * Control and inspection of the simulated MicroGamer hardware, for host
+ * builds.
+ */
+
+#ifndef MICROGAMER_HOST_H
+#define MICROGAMER_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** \brief
+ * A software model of the SSD1306 display controller.
+ *
+ * \details
+ * The model decodes the I2C stream sent by the TWI model, executing the
+ * commands and writing the pixel data to its own 128x64 display RAM, using
+ * the same addressing rules as the real controller.
+ */
+class SSD1306Model
+{
+  public:
+    SSD1306Model();
+
+    // Reset the controller to its power on state and clear the statistics.
+    void reset();
+
+    // Clear the statistics only.
+    void resetStats();
+
+    /** \brief
+     * Get a pixel of the panel, as it would be seen.
+     *
+     * \details
+     * The display start line, segment remap, COM scan direction, inverse
+     * and entire display on settings are applied to the display RAM.
+     * Returns 0 for all pixels while the display is off.
+     */
+    uint8_t panelPixel(uint8_t x, uint8_t y) const;
+
+    // Write the panel as a binary PBM image. Returns false on error.
+    bool writePBM(const char *fileName) const;
+
+    // I2C stream, called by the TWI model
+    void beginTransaction(uint8_t address);
+    void receive(uint8_t b);
+    void endTransaction();
+
+    uint8_t ram[8][128]; // display RAM, [page][column]
+
+    // controller state
+    bool displayOn;
+    bool entireDisplayOn;
+    bool inverse;
+    bool segmentRemap;
+    bool comScanDecrement;
+    uint8_t contrast;
+    uint8_t startLine;
+    uint8_t displayOffset;
+    uint8_t memoryMode;
+    uint8_t columnStart, columnEnd;
+    uint8_t pageStart, pageEnd;
+    uint8_t column, page;
+    bool scrollActive;
+    uint8_t scrollSetup[7]; // last scroll setup command and its arguments
+    uint8_t verticalScrollArea[2];
+
+    // statistics since the last reset
+    uint32_t transactions;
+    uint32_t commandBytes;  // command bytes, including their arguments
+    uint32_t dataBytes;     // pixel data bytes
+    uint32_t controlBytes;
+    uint32_t pixelWrites[8][128]; // data writes to each RAM location
+
+  private:
+    void command(uint8_t b);
+    void data(uint8_t b);
+
+    bool addressed;
+    bool expectControl;
+    bool continuation;
+    bool dataMode;
+    uint8_t cmd[8];
+    uint8_t cmdLength;
+    uint8_t cmdExpected;
+};
+
+/** \brief
+ * The simulated MicroGamer hardware.
+ *
+ * \details
+ * Time is virtual. Code runs in zero time, while TWI bytes take the time
+ * they would on a 400 kHz bus. The clock advances when the sketch waits,
+ * using `delay()`, `yield()` or `MicroGamerCore::idle()`, or polls a
+ * peripheral event which hasn't happened yet. Interrupt handlers are called
+ * when their events happen, unless interrupts are disabled.
+ */
+namespace MicroGamerHost
+{
+  extern SSD1306Model display;
+
+  // Bytes clocked on the I2C bus, including addresses, since the last reset
+  extern uint32_t busBytes;
+  // Time the I2C bus was busy, in nanoseconds, since the last reset
+  extern uint64_t busTimeNs;
+
+  // Virtual time in nanoseconds since the start.
+  uint64_t nanos();
+
+  // Advance the virtual time, handling the peripheral events on the way.
+  void advance(uint64_t ns);
+
+  // Advance the virtual time to the next peripheral event, if any.
+  // Returns false if no event is pending.
+  bool runNextEvent();
+
+  // Wait until all TWI transfers are complete.
+  void flush();
+
+  // Set the level read from an input pin, to simulate the buttons.
+  void setPin(uint8_t pin, uint8_t level);
+
+  // Press or release buttons, using the LEFT_BUTTON ... B_BUTTON masks.
+  void setButtons(uint8_t buttons);
+
+  // Clear the bus and display statistics.
+  void resetStats();
+}
+
+#endif
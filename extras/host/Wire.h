@@ -0,0 +1,22 @@
+/**
+ * @file Wire.h
+ * \brief
+ * The Arduino Wire library, for host builds. The MicroGamer library drives
+ * the TWI peripheral directly, so only the initialization is needed.
+ */
+
+#ifndef MICROGAMER_HOST_WIRE_H
+#define MICROGAMER_HOST_WIRE_H
+
+#include <stdint.h>
+
+class TwoWire
+{
+  public:
+    void begin();
+    void setClock(uint32_t clock);
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file main.cpp
+ * \brief
+ * Runs a sketch on the simulated MicroGamer hardware, for host builds.
+ *
+ * \details
+ * The sketch's `setup()` is called once, then `loop()` is called until the
+ * requested virtual time has elapsed. The display can then be saved as an
+ * image and the transfer statistics are printed.
+ *
+ *     sketch [-t ms] [-b ms:buttons]... [-o file.pbm]
+ *
+ * -t  Virtual time to run the sketch for, in milliseconds (default 1000).
+ * -b  Set the pressed buttons at a given time. `buttons` is a mask of the
+ *     LEFT_BUTTON ... B_BUTTON values, as a decimal or 0x prefixed number.
+ *     Can be given several times, in time order.
+ * -o  Write the contents of the display to a binary PBM image at the end.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "MicroGamerHost.h"
+
+void setup();
+void loop();
+
+// Time taken by a call of loop() which doesn't wait for anything
+#define LOOP_NS 10000ULL
+
+#define MAX_BUTTON_EVENTS 64
+
+struct ButtonEvent
+{
+  unsigned long ms;
+  uint8_t buttons;
+};
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [-t ms] [-b ms:buttons]... [-o file.pbm]\n",
+          name);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long runMs = 1000;
+  const char *imageFile = NULL;
+  ButtonEvent events[MAX_BUTTON_EVENTS];
+  uint8_t eventCount = 0;
+  uint8_t nextEvent = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:b:o:")) != -1) {
+    switch (opt) {
+      case 't':
+        runMs = strtoul(optarg, NULL, 0);
+        break;
+
+      case 'b': {
+        char *end;
+        if (eventCount == MAX_BUTTON_EVENTS) {
+          fprintf(stderr, "too many button events\n");
+          return 2;
+        }
+        events[eventCount].ms = strtoul(optarg, &end, 0);
+        if (*end != ':') {
+          usage(argv[0]);
+          return 2;
+        }
+        events[eventCount].buttons = strtoul(end + 1, NULL, 0);
+        eventCount++;
+        break;
+      }
+
+      case 'o':
+        imageFile = optarg;
+        break;
+
+      default:
+        usage(argv[0]);
+        return 2;
+    }
+  }
+
+  setup();
+
+  while (millis() < runMs) {
+    while (nextEvent < eventCount && events[nextEvent].ms <= millis()) {
+      MicroGamerHost::setButtons(events[nextEvent].buttons);
+      nextEvent++;
+    }
+
+    uint64_t start = MicroGamerHost::nanos();
+    loop();
+    if (MicroGamerHost::nanos() == start) {
+      // don't spin in zero time when the sketch is polling
+      MicroGamerHost::advance(LOOP_NS);
+    }
+  }
+
+  MicroGamerHost::flush();
+
+  const SSD1306Model &display = MicroGamerHost::display;
+  printf("time %lu ms\n", millis());
+  printf("bus bytes %u, busy %.1f%%\n", MicroGamerHost::busBytes,
+         100.0 * MicroGamerHost::busTimeNs / MicroGamerHost::nanos());
+  printf("transactions %u, data bytes %u, command bytes %u\n",
+         display.transactions, display.dataBytes, display.commandBytes);
+
+  if (imageFile != NULL && !display.writePBM(imageFile)) {
+    perror(imageFile);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file nrf.h
+ * \brief
+ * Software models of the nRF51 peripherals used by the MicroGamer library,
+ * for host builds.
+ */
+
+#ifndef MICROGAMER_HOST_NRF_H
+#define MICROGAMER_HOST_NRF_H
+
+#include <stdint.h>
+
+/** \brief
+ * A 32 bit peripheral register of the host peripheral models.
+ *
+ * \details
+ * Reads and writes behave like plain memory unless the owning peripheral
+ * model installs handlers, which are then called for every access. This
+ * allows code written for the nRF51 registers to drive the models unchanged.
+ */
+struct HostRegister
+{
+  uint32_t value;
+  void (*onWrite)(HostRegister &reg, uint32_t value);
+  uint32_t (*onRead)(HostRegister &reg);
+
+  HostRegister &operator=(uint32_t v)
+  {
+    if (onWrite != 0) {
+      onWrite(*this, v);
+    } else {
+      value = v;
+    }
+    return *this;
+  }
+
+  HostRegister &operator=(HostRegister &other)
+  {
+    return *this = (uint32_t)other;
+  }
+
+  operator uint32_t()
+  {
+    return onRead != 0 ? onRead(*this) : value;
+  }
+};
+
+// Two Wire Interface
+
+struct NRF_TWI_Type
+{
+  HostRegister TASKS_STARTRX;
+  HostRegister TASKS_STARTTX;
+  HostRegister TASKS_STOP;
+  HostRegister TASKS_SUSPEND;
+  HostRegister TASKS_RESUME;
+  HostRegister EVENTS_STOPPED;
+  HostRegister EVENTS_RXDREADY;
+  HostRegister EVENTS_TXDSENT;
+  HostRegister EVENTS_ERROR;
+  HostRegister EVENTS_BB;
+  HostRegister EVENTS_SUSPENDED;
+  HostRegister SHORTS;
+  HostRegister INTEN;
+  HostRegister INTENSET;
+  HostRegister INTENCLR;
+  HostRegister ERRORSRC;
+  HostRegister ENABLE;
+  HostRegister PSELSCL;
+  HostRegister PSELSDA;
+  HostRegister RXD;
+  HostRegister TXD;
+  HostRegister FREQUENCY;
+  HostRegister ADDRESS;
+};
+
+#define TWI_INTENSET_STOPPED_Pos (1UL)
+#define TWI_INTENSET_STOPPED_Set (1UL)
+#define TWI_INTENSET_RXDREADY_Pos (2UL)
+#define TWI_INTENSET_RXDREADY_Set (1UL)
+#define TWI_INTENSET_TXDSENT_Pos (7UL)
+#define TWI_INTENSET_TXDSENT_Set (1UL)
+#define TWI_INTENSET_ERROR_Pos (9UL)
+#define TWI_INTENSET_ERROR_Set (1UL)
+
+#define TWI_ERRORSRC_ANACK_Msk (0x1UL << 1)
+#define TWI_ERRORSRC_DNACK_Msk (0x1UL << 2)
+
+// Timer
+
+struct NRF_TIMER_Type
+{
+  HostRegister TASKS_START;
+  HostRegister TASKS_STOP;
+  HostRegister TASKS_COUNT;
+  HostRegister TASKS_CLEAR;
+  HostRegister TASKS_SHUTDOWN;
+  HostRegister TASKS_CAPTURE[4];
+  HostRegister EVENTS_COMPARE[4];
+  HostRegister SHORTS;
+  HostRegister INTENSET;
+  HostRegister INTENCLR;
+  HostRegister MODE;
+  HostRegister BITMODE;
+  HostRegister PRESCALER;
+  HostRegister CC[4];
+};
+
+#define TIMER_MODE_MODE_Pos (0UL)
+#define TIMER_MODE_MODE_Msk (0x1UL << TIMER_MODE_MODE_Pos)
+#define TIMER_MODE_MODE_Timer (0UL)
+#define TIMER_BITMODE_BITMODE_Pos (0UL)
+#define TIMER_BITMODE_BITMODE_Msk (0x3UL << TIMER_BITMODE_BITMODE_Pos)
+#define TIMER_BITMODE_BITMODE_32Bit (0x03UL)
+#define TIMER_PRESCALER_PRESCALER_Pos (0UL)
+#define TIMER_PRESCALER_PRESCALER_Msk (0xFUL << TIMER_PRESCALER_PRESCALER_Pos)
+#define TIMER_SHORTS_COMPARE0_CLEAR_Pos (0UL)
+#define TIMER_SHORTS_COMPARE0_CLEAR_Msk (0x1UL << TIMER_SHORTS_COMPARE0_CLEAR_Pos)
+#define TIMER_SHORTS_COMPARE0_CLEAR_Enabled (1UL)
+#define TIMER_INTENSET_COMPARE0_Pos (16UL)
+#define TIMER_INTENSET_COMPARE0_Set (1UL)
+
+// Non-volatile memory controller
+
+struct NRF_NVMC_Type
+{
+  HostRegister READY;
+  HostRegister CONFIG;
+  HostRegister ERASEPAGE;
+  HostRegister ERASEPCR1;
+  HostRegister ERASEALL;
+  HostRegister ERASEPCR0;
+  HostRegister ERASEUICR;
+};
+
+#define NVMC_CONFIG_WEN_Pos (0UL)
+#define NVMC_CONFIG_WEN_Ren (0x00UL)
+#define NVMC_CONFIG_WEN_Wen (0x01UL)
+#define NVMC_CONFIG_WEN_Een (0x02UL)
+
+extern NRF_TWI_Type hostTwi1;
+extern NRF_TIMER_Type hostTimer2;
+extern NRF_NVMC_Type hostNvmc;
+
+#define NRF_TWI1 (&hostTwi1)
+#define NRF_TIMER2 (&hostTimer2)
+#define NRF_NVMC (&hostNvmc)
+
+// Interrupts
+
+typedef enum
+{
+  SPI1_TWI1_IRQn = 4,
+  TIMER2_IRQn = 10
+} IRQn_Type;
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+void __disable_irq();
+void __enable_irq();
+
+extern "C" {
+void SPI1_TWI1_IRQHandler(void);
+void TIMER2_IRQHandler(void);
+}
+
+#endif
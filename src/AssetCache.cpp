@@ -0,0 +1,105 @@
+/**
+ * @file AssetCache.cpp
+ * \brief
+ * A class keeping decompressed copies of compressed bitmaps in RAM.
+ */
+
+#include "AssetCache.h"
+
+// the entries are kept aligned for their header, which holds a pointer
+#define ENTRY_ALIGN alignof(Entry)
+#define ALIGN_ENTRY(n) (((n) + ENTRY_ALIGN - 1) & ~(ENTRY_ALIGN - 1))
+
+AssetCache::AssetCache(uint8_t *pool, uint16_t size)
+  : useCount(0)
+{
+  // skip the bytes before the first aligned address
+  uint8_t skip = -(uintptr_t)pool & (ENTRY_ALIGN - 1);
+  this->pool = pool + skip;
+  this->size = size > skip ? (size - skip) & ~(ENTRY_ALIGN - 1) : 0;
+  used = 0;
+}
+
+void AssetCache::clear()
+{
+  used = 0;
+}
+
+const uint8_t *AssetCache::get(const uint8_t *bitmap)
+{
+  Entry *entry;
+
+  for (uint16_t ofs = 0; ofs < used; ofs += entry->size) {
+    entry = (Entry *)(pool + ofs);
+    if (entry->bitmap == bitmap) {
+      entry->lastUse = ++useCount;
+      return (const uint8_t *)(entry + 1);
+    }
+  }
+
+  uint16_t w = pgm_read_byte(bitmap) + 1;
+  uint16_t h = pgm_read_byte(bitmap + 1) + 1;
+
+  // drawBitmap() can't draw a bitmap 256 pixels wide or high
+  if (w > 255 || h > 255) {
+    return NULL;
+  }
+
+  uint16_t entrySize = ALIGN_ENTRY(sizeof(Entry) + w * ((h + 7) / 8));
+
+  if (entrySize > size) {
+    return NULL;
+  }
+  while (size - used < entrySize) {
+    evict();
+  }
+
+  entry = (Entry *)(pool + used);
+  entry->bitmap = bitmap;
+  entry->lastUse = ++useCount;
+  entry->size = entrySize;
+  used += entrySize;
+
+  MicroGamerBase::decompress((uint8_t *)(entry + 1), bitmap);
+  return (const uint8_t *)(entry + 1);
+}
+
+void AssetCache::draw(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t color)
+{
+  uint16_t w = pgm_read_byte(bitmap) + 1;
+  uint16_t h = pgm_read_byte(bitmap + 1) + 1;
+
+  // no need to decompress it if it's outside the clip rectangle
+  int16_t sx = x + MicroGamerBase::originX;
+  int16_t sy = y + MicroGamerBase::originY;
+  if (sx + w <= MicroGamerBase::clipLeft || sx >= MicroGamerBase::clipRight ||
+      sy + h <= MicroGamerBase::clipTop || sy >= MicroGamerBase::clipBottom) {
+    return;
+  }
+
+  const uint8_t *data = get(bitmap);
+  if (data != NULL) {
+    MicroGamerBase::drawBitmap(x, y, data, w, h, color);
+  } else {
+    MicroGamerBase::drawCompressed(x, y, bitmap, color);
+  }
+}
+
+void AssetCache::evict()
+{
+  Entry *oldest = NULL;
+  Entry *entry;
+
+  for (uint16_t ofs = 0; ofs < used; ofs += entry->size) {
+    entry = (Entry *)(pool + ofs);
+    if (oldest == NULL || entry->lastUse < oldest->lastUse) {
+      oldest = entry;
+    }
+  }
+
+  // the following entries are moved down over it
+  uint8_t *start = (uint8_t *)oldest;
+  uint16_t entrySize = oldest->size;
+  memmove(start, start + entrySize, pool + used - (start + entrySize));
+  used -= entrySize;
+}
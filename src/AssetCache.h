@@ -0,0 +1,116 @@
+/**
+ * @file AssetCache.h
+ * \brief
+ * A class keeping decompressed copies of compressed bitmaps in RAM.
+ */
+
+#ifndef AssetCache_h
+#define AssetCache_h
+
+#include "MicroGamer.h"
+
+/** \brief
+ * A class keeping decompressed copies of compressed bitmaps in RAM.
+ *
+ * \details
+ * `MicroGamerBase::drawCompressed()` decodes its bitmap each time it's
+ * called, which is wasted work for a title screen or a background drawn
+ * every frame. An asset cache decodes each compressed bitmap once, with
+ * `MicroGamerBase::decompress()`, into a pool of RAM provided by the
+ * sketch, and then draws the decoded copy with
+ * `MicroGamerBase::drawBitmap()`.
+ *
+ * The size of the pool sets the budget of the cache. When a bitmap that
+ * isn't in the cache doesn't fit in the remaining space, the least
+ * recently used bitmaps are removed until it does. A bitmap too large for
+ * the whole pool, or 256 pixels wide or high, is drawn with
+ * `drawCompressed()` instead.
+ *
+ * Each bitmap takes `w * ((h + 7) / 8)` bytes of the pool, plus a small
+ * header (12 bytes on the micro:bit), rounded up to a multiple of the
+ * header's alignment (4 bytes on the micro:bit).
+ *
+ * \code
+ * uint8_t pool[1200];
+ * AssetCache cache(pool, sizeof(pool));
+ *
+ * void loop() {
+ *   cache.draw(0, 0, background);
+ *   cache.draw(40, 20, title);
+ *   mg.display();
+ * }
+ * \endcode
+ *
+ * \see MicroGamerBase::drawCompressed() MicroGamerBase::decompress()
+ */
+class AssetCache
+{
+ public:
+  /** \brief
+   * Create an asset cache.
+   *
+   * \param pool An array to keep the decompressed bitmaps in.
+   * \param size The size of the array, in bytes.
+   */
+  AssetCache(uint8_t *pool, uint16_t size);
+
+  /** \brief
+   * Remove all the bitmaps from the cache.
+   *
+   * \details
+   * This must be called if the pool is used for something else.
+   */
+  void clear();
+
+  /** \brief
+   * Get the decompressed copy of a compressed bitmap.
+   *
+   * \param bitmap A pointer to the compressed bitmap array in program memory.
+   *
+   * \return A pointer to the bitmap in the format used by
+   * `MicroGamerBase::drawBitmap()`, or `NULL` if it's too large for the
+   * pool or 256 pixels wide or high.
+   *
+   * \details
+   * The bitmap is decompressed if it isn't already in the cache. The
+   * pointer is only valid until the next call of `get()` or `draw()` with
+   * another bitmap, which can move or remove it.
+   */
+  const uint8_t *get(const uint8_t *bitmap);
+
+  /** \brief
+   * Draw a compressed bitmap, decompressing it only if it isn't cached.
+   *
+   * \param x The X coordinate of the top left pixel affected by the bitmap.
+   * \param y The Y coordinate of the top left pixel affected by the bitmap.
+   * \param bitmap A pointer to the compressed bitmap array in program memory.
+   * \param color The color of pixels for bits set to 1 in the bitmap, as for
+   * `MicroGamerBase::drawBitmap()`. (optional; defaults to WHITE).
+   *
+   * \details
+   * A bitmap that is completely outside of the clip rectangle isn't
+   * decompressed.
+   *
+   * \see MicroGamerBase::drawCompressed()
+   */
+  void draw(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t color = WHITE);
+
+ protected:
+  // The header of a cached bitmap, followed by its data
+  struct Entry
+  {
+    const uint8_t *bitmap; // the compressed bitmap
+    uint32_t lastUse;      // the value of useCount when it was last used
+    uint16_t size;         // the size of the entry, header included
+  };
+
+  // Remove the least recently used entry
+  void evict();
+
+  uint8_t *pool;
+  uint16_t size;
+  uint16_t used;
+  uint32_t useCount;
+};
+
+#endif
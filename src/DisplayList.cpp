@@ -0,0 +1,338 @@
+/**
+ * @file DisplayList.cpp
+ * \brief
+ * A class recording drawing commands, to draw them one page at a time.
+ */
+
+#include "DisplayList.h"
+
+// Command types
+#define DL_PIXEL 0
+#define DL_FILL_RECT 1
+#define DL_RECT 2
+#define DL_LINE 3
+#define DL_CIRCLE 4
+#define DL_FILL_CIRCLE 5
+#define DL_BITMAP 6
+#define DL_SPRITE 7
+#define DL_CHAR 8
+#define DL_CLIP 9
+
+DisplayList *DisplayList::stripList;
+
+DisplayList::DisplayList(MicroGamer &mg, DisplayCommand *commands, uint8_t size)
+  : mg(mg), commands(commands), size(size)
+{
+  clear();
+}
+
+void DisplayList::clear()
+{
+  used = 0;
+  clip.left = 0;
+  clip.top = 0;
+  clip.right = WIDTH;
+  clip.bottom = HEIGHT;
+}
+
+uint8_t DisplayList::count() const
+{
+  return used;
+}
+
+bool DisplayList::full() const
+{
+  return used == size;
+}
+
+DisplayCommand *DisplayList::add(uint8_t type, int16_t x, int16_t y,
+                                 int32_t w, int32_t h, uint8_t color)
+{
+  const ClipRect &view = MicroGamerBase::clipRect;
+
+  // the commands are recorded in display coordinates
+  x += MicroGamerBase::originX;
+  y += MicroGamerBase::originY;
+
+  // discard the commands which are completely outside the clip rectangle
+  if (w <= 0 || h <= 0 || x + w <= view.left || x >= view.right ||
+      y + h <= view.top || y >= view.bottom || used == size) {
+    return NULL;
+  }
+
+  // the clip rectangle is recorded when it changes, drawing on all pages
+  if (view.left != clip.left || view.top != clip.top ||
+      view.right != clip.right || view.bottom != clip.bottom) {
+    if (used + 1 == size) {
+      return NULL;
+    }
+    DisplayCommand *command = &commands[used++];
+    command->type = DL_CLIP;
+    command->pages = 0xFF;
+    command->x = view.left;
+    command->y = view.top;
+    command->a = view.right;
+    command->b = view.bottom;
+    clip = view;
+  }
+
+  int32_t yEnd = y + h - 1;
+  uint8_t firstPage = y < view.top ? view.top / 8 : y / 8;
+  uint8_t lastPage = yEnd >= view.bottom ? (view.bottom - 1) / 8 : yEnd / 8;
+
+  DisplayCommand *command = &commands[used++];
+  command->type = type;
+  command->color = color;
+  command->pages = (0xFF << firstPage) & (0xFF >> (7 - lastPage));
+  command->x = x;
+  command->y = y;
+  return command;
+}
+
+void DisplayList::drawPixel(int16_t x, int16_t y, uint8_t color)
+{
+  add(DL_PIXEL, x, y, 1, 1, color);
+}
+
+void DisplayList::drawFastVLine(int16_t x, int16_t y, uint8_t h, uint8_t color)
+{
+  fillRect(x, y, 1, h, color);
+}
+
+void DisplayList::drawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+void DisplayList::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
+{
+  // the ends in display coordinates, as MicroGamerBase::drawLine() moves
+  // them, and the bounding box of the line between them
+  int16_t sx0 = x0 + MicroGamerBase::originX;
+  int16_t sy0 = y0 + MicroGamerBase::originY;
+  int16_t sx1 = x1 + MicroGamerBase::originX;
+  int16_t sy1 = y1 + MicroGamerBase::originY;
+  int16_t left = (sx0 < sx1 ? sx0 : sx1) - MicroGamerBase::originX;
+  int16_t top = (sy0 < sy1 ? sy0 : sy1) - MicroGamerBase::originY;
+
+  DisplayCommand *command = add(DL_LINE, left, top, abs(sx1 - sx0) + 1,
+                                abs(sy1 - sy0) + 1, color);
+  if (command != NULL) {
+    // the ends, rather than the bounding box
+    command->x = sx0;
+    command->y = sy0;
+    command->a = sx1;
+    command->b = sy1;
+  }
+}
+
+void DisplayList::drawRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+  // with a zero width or height, MicroGamerBase::drawRect() still draws
+  // the two other sides, one pixel before and on the rectangle's edge
+  if (w == 0 && h == 0) {
+    return;
+  }
+  DisplayCommand *command = add(DL_RECT, w == 0 ? x - 1 : x, h == 0 ? y - 1 : y,
+                                w == 0 ? 2 : w, h == 0 ? 2 : h, color);
+  if (command != NULL) {
+    command->x = x + MicroGamerBase::originX;
+    command->y = y + MicroGamerBase::originY;
+    command->a = w;
+    command->b = h;
+  }
+}
+
+void DisplayList::fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+  DisplayCommand *command = add(DL_FILL_RECT, x, y, w, h, color);
+  if (command != NULL) {
+    command->a = w;
+    command->b = h;
+  }
+}
+
+void DisplayList::drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
+{
+  DisplayCommand *command = add(DL_CIRCLE, x0 - r, y0 - r,
+                                2 * r + 1, 2 * r + 1, color);
+  if (command != NULL) {
+    command->x = x0 + MicroGamerBase::originX;
+    command->y = y0 + MicroGamerBase::originY;
+    command->a = r;
+  }
+}
+
+void DisplayList::fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
+{
+  DisplayCommand *command = add(DL_FILL_CIRCLE, x0 - r, y0 - r,
+                                2 * r + 1, 2 * r + 1, color);
+  if (command != NULL) {
+    command->x = x0 + MicroGamerBase::originX;
+    command->y = y0 + MicroGamerBase::originY;
+    command->a = r;
+  }
+}
+
+void DisplayList::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color)
+{
+  DisplayCommand *command = add(DL_BITMAP, x, y, w, h, color);
+  if (command != NULL) {
+    command->a = w;
+    command->b = h;
+    command->data = bitmap;
+  }
+}
+
+void DisplayList::drawSprite(int16_t x, int16_t y, const uint8_t *bitmap,
+                             const uint8_t *mask, uint8_t frame,
+                             uint8_t drawMode)
+{
+  if (bitmap == NULL)
+    return;
+
+  uint8_t width = pgm_read_byte(bitmap);
+  uint8_t height = pgm_read_byte(++bitmap);
+  bitmap++;
+
+  // resolved now as in Sprites::draw(), so it's only done once per frame
+  if (drawMode == SPRITE_AUTO_MODE) {
+    drawMode = mask == NULL ? SPRITE_UNMASKED : SPRITE_MASKED;
+  }
+  if (frame > 0) {
+    unsigned int frame_offset = width * (height / 8 + (height % 8 == 0 ? 0 : 1));
+    // sprite plus mask uses twice as much space for each frame
+    if (drawMode == SPRITE_PLUS_MASK) {
+      frame_offset *= 2;
+    } else if (mask != NULL) {
+      mask += frame * frame_offset;
+    }
+    bitmap += frame * frame_offset;
+  }
+
+  DisplayCommand *command = add(DL_SPRITE, x, y, width, height, drawMode);
+  if (command != NULL) {
+    command->a = width;
+    command->b = height;
+    command->data = bitmap;
+    command->mask = mask;
+  }
+}
+
+void DisplayList::drawChar(int16_t x, int16_t y, unsigned char c, uint8_t color, uint8_t bg, uint8_t size)
+{
+  // 5x7 characters plus a column and a row of background
+  DisplayCommand *command = add(DL_CHAR, x, y, 6 * size, 8 * size, color);
+  if (command != NULL) {
+    command->extra = c;
+    command->a = bg;
+    command->b = size;
+  }
+}
+
+void DisplayList::render()
+{
+  int16_t top = MicroGamerBase::stripTop;
+  int16_t bottom = MicroGamerBase::stripBottom;
+
+  for (uint8_t page = 0; page < HEIGHT / 8; page++) {
+    // the page, within the strip rows which were set
+    int16_t pageTop = page * 8;
+    MicroGamerBase::stripTop = top > pageTop ? top : pageTop;
+    MicroGamerBase::stripBottom = bottom < pageTop + 8 ? bottom : pageTop + 8;
+    if (MicroGamerBase::stripTop < MicroGamerBase::stripBottom) {
+      MicroGamerBase::updateClip();
+      renderPage(page);
+    }
+  }
+
+  MicroGamerBase::stripTop = top;
+  MicroGamerBase::stripBottom = bottom;
+  MicroGamerBase::updateClip();
+}
+
+void DisplayList::renderPage(uint8_t page)
+{
+  uint8_t pageBit = 1 << page;
+
+  // the commands are in display coordinates, and drawn within both their
+  // clip rectangle and the current one
+  ClipRect current = MicroGamerBase::clipRect;
+  int16_t originX = MicroGamerBase::originX;
+  int16_t originY = MicroGamerBase::originY;
+  MicroGamerBase::originX = 0;
+  MicroGamerBase::originY = 0;
+
+  for (DisplayCommand *command = commands; command < commands + used; command++) {
+    if ((command->pages & pageBit) == 0) {
+      continue;
+    }
+
+    if (command->type == DL_CLIP) {
+      ClipRect &view = MicroGamerBase::clipRect;
+      view.left = command->x > current.left ? command->x : current.left;
+      view.top = command->y > current.top ? command->y : current.top;
+      view.right = command->a < current.right ? command->a : current.right;
+      view.bottom = command->b < current.bottom ? command->b : current.bottom;
+      MicroGamerBase::updateClip();
+      continue;
+    }
+
+    switch (command->type) {
+      case DL_PIXEL:
+        mg.drawPixel(command->x, command->y, command->color);
+        break;
+
+      case DL_FILL_RECT:
+        mg.fillRect(command->x, command->y, command->a, command->b, command->color);
+        break;
+
+      case DL_RECT:
+        mg.drawRect(command->x, command->y, command->a, command->b, command->color);
+        break;
+
+      case DL_LINE:
+        mg.drawLine(command->x, command->y, command->a, command->b, command->color);
+        break;
+
+      case DL_CIRCLE:
+        mg.drawCircle(command->x, command->y, command->a, command->color);
+        break;
+
+      case DL_FILL_CIRCLE:
+        mg.fillCircle(command->x, command->y, command->a, command->color);
+        break;
+
+      case DL_BITMAP:
+        MicroGamerBase::drawBitmap(command->x, command->y, command->data,
+                                   command->a, command->b, command->color);
+        break;
+
+      case DL_SPRITE:
+        Sprites::drawBitmap(command->x, command->y, command->data, command->mask,
+                            command->a, command->b, command->color);
+        break;
+
+      case DL_CHAR:
+        mg.drawChar(command->x, command->y, command->extra, command->color,
+                    command->a, command->b);
+        break;
+    }
+  }
+
+  MicroGamerBase::clipRect = current;
+  MicroGamerBase::originX = originX;
+  MicroGamerBase::originY = originY;
+  MicroGamerBase::updateClip();
+}
+
+void DisplayList::setStripRenderer()
+{
+  stripList = this;
+  mg.setStripRenderer(renderStrip);
+}
+
+void DisplayList::renderStrip(uint8_t page)
+{
+  stripList->renderPage(page);
+}
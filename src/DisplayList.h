@@ -0,0 +1,261 @@
+/**
+ * @file DisplayList.h
+ * \brief
+ * A class recording drawing commands, to draw them one page at a time.
+ */
+
+#ifndef DisplayList_h
+#define DisplayList_h
+
+#include "MicroGamer.h"
+
+/** \brief
+ * A recorded drawing command.
+ *
+ * \details
+ * The commands of a `DisplayList` are stored in an array of this type,
+ * provided by the sketch. The members aren't part of the API.
+ */
+struct DisplayCommand
+{
+  uint8_t type;
+  uint8_t color;  // or the Sprites draw mode
+  uint8_t pages;  // bit n set if the command draws on page n
+  uint8_t extra;  // the character
+  int16_t x, y;
+  int16_t a, b;   // width and height, the end of a line, the radius,
+                  // or a character's background and size
+  const uint8_t *data;
+  const uint8_t *mask;
+};
+
+/** \brief
+ * A class recording drawing commands, to draw them one page at a time.
+ *
+ * \details
+ * The drawing functions of `MicroGamerBase` and `Sprites` each go through
+ * the part of the display buffer they modify, so drawing overlapping
+ * objects reads and writes the same bytes again. A display list instead
+ * records the drawing commands of a frame, and draws them later one page
+ * (8 pixel high row of the display) at a time: each page of the display
+ * buffer is completed before moving on to the next one.
+ *
+ * The commands are stored in an array provided by the sketch. When a
+ * command is recorded, the pages it draws on are worked out, and commands
+ * that are completely off the screen are discarded. The commands of each
+ * page are then drawn in the order they were recorded, clipped to the page,
+ * skipping those that don't draw on it.
+ *
+ * Commands are recorded in the viewport set with
+ * `MicroGamerBase::pushViewport()` when they're recorded, and drawn clipped
+ * to the clip rectangle in effect then, as well as to the one in effect
+ * when they're drawn. Each change of the clip rectangle between recorded
+ * commands takes a command of the array.
+ *
+ * A list can be drawn in the display buffer with `render()`, then sent with
+ * `MicroGamerBase::display()` as usual. It can also be set as the strip
+ * renderer with `setStripRenderer()`, so that `display()` draws each page
+ * of the list in a strip which is sent while the next page is drawn.
+ *
+ * \code
+ * DisplayCommand commands[64];
+ * DisplayList list(mg, commands, 64);
+ *
+ * void loop() {
+ *   list.clear();
+ *   list.fillRect(0, 56, 128, 8);
+ *   list.drawSprite(playerX, playerY, player, mask, frame);
+ *   list.setStripRenderer();
+ *   mg.display();
+ * }
+ * \endcode
+ *
+ * \see MicroGamerBase::setStripRenderer()
+ */
+class DisplayList
+{
+ public:
+  /** \brief
+   * Create a display list.
+   *
+   * \param mg The object used to draw the commands.
+   * \param commands An array to record the commands in.
+   * \param size The number of elements of the array.
+   */
+  DisplayList(MicroGamer &mg, DisplayCommand *commands, uint8_t size);
+
+  /** \brief
+   * Remove all the commands, to record a new frame.
+   */
+  void clear();
+
+  /** \brief
+   * Get the number of recorded commands.
+   *
+   * \return The number of commands that will be drawn.
+   *
+   * \see full()
+   */
+  uint8_t count() const;
+
+  /** \brief
+   * Test if the list is full.
+   *
+   * \return `true` if the array of commands is full. Commands recorded
+   * after that are dropped.
+   */
+  bool full() const;
+
+  /** \brief
+   * Record a pixel.
+   *
+   * \see MicroGamerBase::drawPixel()
+   */
+  void drawPixel(int16_t x, int16_t y, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a vertical line.
+   *
+   * \see MicroGamerBase::drawFastVLine()
+   */
+  void drawFastVLine(int16_t x, int16_t y, uint8_t h, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a horizontal line.
+   *
+   * \see MicroGamerBase::drawFastHLine()
+   */
+  void drawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a line.
+   *
+   * \see MicroGamerBase::drawLine()
+   */
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a rectangle outline.
+   *
+   * \see MicroGamerBase::drawRect()
+   */
+  void drawRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a filled rectangle.
+   *
+   * \see MicroGamerBase::fillRect()
+   */
+  void fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a circle outline.
+   *
+   * \see MicroGamerBase::drawCircle()
+   */
+  void drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a filled circle.
+   *
+   * \see MicroGamerBase::fillCircle()
+   */
+  void fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a bitmap.
+   *
+   * \details
+   * The bitmap array must not be modified until the list has been drawn.
+   *
+   * \see MicroGamerBase::drawBitmap()
+   */
+  void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color = WHITE);
+
+  /** \brief
+   * Record a sprite.
+   *
+   * \param x,y The coordinates of the top left pixel location.
+   * \param bitmap A pointer to the array containing the image frames.
+   * \param mask A pointer to the array containing the mask frames, or
+   * `NULL` to draw the sprite like `Sprites::drawOverwrite()`.
+   * \param frame The frame number of the image (and mask) to draw.
+   * \param drawMode One of `SPRITE_MASKED`, `SPRITE_OVERWRITE`,
+   * `SPRITE_PLUS_MASK`, `SPRITE_IS_MASK` or `SPRITE_IS_MASK_ERASE`, or
+   * `SPRITE_AUTO_MODE` to use `SPRITE_MASKED` if there is a mask and
+   * `SPRITE_OVERWRITE` otherwise.
+   *
+   * \details
+   * The sprite is drawn like with the `Sprites` function for the mode, for
+   * instance `Sprites::drawPlusMask()` for `SPRITE_PLUS_MASK`.
+   *
+   * \see Sprites
+   */
+  void drawSprite(int16_t x, int16_t y, const uint8_t *bitmap,
+                  const uint8_t *mask, uint8_t frame,
+                  uint8_t drawMode = SPRITE_AUTO_MODE);
+
+  /** \brief
+   * Record a character.
+   *
+   * \see MicroGamer::drawChar()
+   */
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint8_t color = WHITE, uint8_t bg = BLACK, uint8_t size = 1);
+
+  /** \brief
+   * Draw the commands in the display buffer.
+   *
+   * \details
+   * The commands are drawn one page at a time, over the current contents of
+   * the display buffer, and the list is kept: it can be drawn again.
+   *
+   * \see setStripRenderer()
+   */
+  void render();
+
+  /** \brief
+   * Draw the commands which draw on a page.
+   *
+   * \param page The page of the display, 0 to 7.
+   *
+   * \details
+   * Only the commands recorded as drawing on the page are drawn. Their
+   * drawing isn't clipped to the page by this function, as it is when called
+   * by a strip renderer.
+   */
+  void renderPage(uint8_t page);
+
+  /** \brief
+   * Draw this list when the display is updated.
+   *
+   * \details
+   * The list is set as the strip renderer of the display, and
+   * `MicroGamerBase::display()` then draws it one page at a time in the
+   * strips. Setting another strip renderer, or `NULL`, stops it.
+   *
+   * \see MicroGamerBase::setStripRenderer()
+   */
+  void setStripRenderer();
+
+ protected:
+  // Record a command if it is inside the clip rectangle, preceded by a
+  // change of the clip rectangle if needed. The size of the bounding box
+  // is 32 bits, as a line can span the whole int16_t range.
+  // Returns the command to complete, or NULL if there is none.
+  DisplayCommand *add(uint8_t type, int16_t x, int16_t y,
+                      int32_t w, int32_t h, uint8_t color);
+
+  static void renderStrip(uint8_t page);
+
+  MicroGamer &mg;
+  DisplayCommand *commands;
+  uint8_t size;
+  uint8_t used;
+  // the clip rectangle of the last command recorded
+  ClipRect clip;
+
+  // the list drawn by renderStrip()
+  static DisplayList *stripList;
+};
+
+#endif
@@ -13,8 +13,24 @@
 //==========================================
 
 uint8_t MicroGamerBase::staticAllocatedBuffer[];
-uint8_t *MicroGamerBase::displayBuffer;
+uint8_t *MicroGamerBase::displayBuffers;
+uint8_t MicroGamerBase::displayBufferCount;
+uint8_t MicroGamerBase::displayBufferIndex;
 uint8_t *MicroGamerBase::sBuffer;
+bool MicroGamerBase::partialUpdates;
+uint8_t MicroGamerBase::scrollOffset;
+void (*MicroGamerBase::stripRenderer)(uint8_t page);
+int16_t MicroGamerBase::clipLeft;
+int16_t MicroGamerBase::clipTop;
+int16_t MicroGamerBase::clipRight;
+int16_t MicroGamerBase::clipBottom;
+int16_t MicroGamerBase::originX;
+int16_t MicroGamerBase::originY;
+ClipRect MicroGamerBase::clipRect;
+int16_t MicroGamerBase::stripTop;
+int16_t MicroGamerBase::stripBottom;
+MicroGamerBase::ClipState MicroGamerBase::clipStack[CLIP_STACK_SIZE];
+uint8_t MicroGamerBase::clipDepth;
 
 MicroGamerBase::MicroGamerBase()
 {
@@ -30,7 +46,28 @@ MicroGamerBase::MicroGamerBase()
   // lastFrameDurationMs
 
   sBuffer = staticAllocatedBuffer;
-  displayBuffer = NULL;
+  displayBuffers = NULL;
+  displayBufferCount = 1;
+  displayBufferIndex = 0;
+  partialUpdates = false;
+  scrollOffset = 0;
+  stripRenderer = NULL;
+
+  clipRect.left = 0;
+  clipRect.top = 0;
+  clipRect.right = WIDTH;
+  clipRect.bottom = HEIGHT;
+  clipDepth = 0;
+  originX = 0;
+  originY = 0;
+  stripTop = 0;
+#ifdef STRIP_RENDERING_ONLY
+  // there is nowhere to draw outside of the strip renderer
+  stripBottom = 0;
+#else
+  stripBottom = HEIGHT;
+#endif
+  updateClip();
 }
 
 // functions called here should be public so users can create their
@@ -278,29 +315,229 @@ void MicroGamerBase::clear()
 //   _BV(0), _BV(1), _BV(2), _BV(3), _BV(4), _BV(5), _BV(6), _BV(7)
 // };
 
-void MicroGamerBase::drawPixel(int16_t x, int16_t y, uint8_t color)
+void MicroGamerBase::updateClip()
+{
+  clipLeft = clipRect.left;
+  clipRight = clipRect.right;
+  clipTop = clipRect.top > stripTop ? clipRect.top : stripTop;
+  clipBottom = clipRect.bottom < stripBottom ? clipRect.bottom : stripBottom;
+
+  // an empty area, for which every test against it fails
+  if (clipLeft >= clipRight || clipTop >= clipBottom) {
+    clipLeft = clipTop = clipRight = clipBottom = 0;
+  }
+}
+
+bool MicroGamerBase::pushClip(Rect clip)
+{
+  if (clipDepth == CLIP_STACK_SIZE) {
+    return false;
+  }
+
+  clipStack[clipDepth].rect = clipRect;
+  clipStack[clipDepth].originX = originX;
+  clipStack[clipDepth].originY = originY;
+  clipDepth++;
+
+  // the part of the rectangle within the current one
+  int16_t left = clip.x + originX;
+  int16_t top = clip.y + originY;
+  int16_t right = left + clip.width;
+  int16_t bottom = top + clip.height;
+  if (left > clipRect.left)
+    clipRect.left = left;
+  if (top > clipRect.top)
+    clipRect.top = top;
+  if (right < clipRect.right)
+    clipRect.right = right;
+  if (bottom < clipRect.bottom)
+    clipRect.bottom = bottom;
+  if (clipRect.left >= clipRect.right || clipRect.top >= clipRect.bottom) {
+    clipRect.left = clipRect.top = clipRect.right = clipRect.bottom = 0;
+  }
+
+  updateClip();
+  return true;
+}
+
+bool MicroGamerBase::pushViewport(Rect viewport)
 {
-  if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) {
+  if (!pushClip(viewport)) {
+    return false;
+  }
+  originX += viewport.x;
+  originY += viewport.y;
+  return true;
+}
+
+void MicroGamerBase::popClip()
+{
+  if (clipDepth == 0) {
     return;
   }
 
+  clipDepth--;
+  clipRect = clipStack[clipDepth].rect;
+  originX = clipStack[clipDepth].originX;
+  originY = clipStack[clipDepth].originY;
+  updateClip();
+}
+
+bool MicroGamerBase::prepareDrawRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t xEnd = x + w;
+  int16_t yEnd = y + h;
+
+  if (x < clipLeft)
+    x = clipLeft;
+  if (xEnd > clipRight)
+    xEnd = clipRight;
+  if (y < clipTop)
+    y = clipTop;
+  if (yEnd > clipBottom)
+    yEnd = clipBottom;
+  if (x >= xEnd || y >= yEnd)
+    return false;
+
+  prepareDraw(x, xEnd - 1, y / 8, (yEnd - 1) / 8);
+  return true;
+}
+
+// Draw the pixels of mask in a byte of the display buffer, with a color
+// known at compile time so that no test is left in the loops using it
+template <uint8_t color>
+static inline __attribute__((always_inline)) void drawPixels(uint8_t *pBuf, uint8_t mask)
+{
+  if (color == WHITE)
+    *pBuf |= mask;
+  else if (color == BLACK)
+    *pBuf &= ~mask;
+  else
+    *pBuf ^= mask;
+}
+
+template <uint8_t color>
+void MicroGamerBase::drawPixel(int16_t x, int16_t y)
+{
+  x += originX;
+  y += originY;
+  if ((x < clipLeft) || (x >= clipRight) || (y < clipTop) || (y >= clipBottom)) {
+    return;
+  }
+
+  prepareDraw(x, x, y / 8, y / 8);
+
   // x is which column
+  drawPixels<color>(&sBuffer[x + (y / 8) * WIDTH], 1 << (y & 7));
+}
+
+template void MicroGamerBase::drawPixel<WHITE>(int16_t x, int16_t y);
+template void MicroGamerBase::drawPixel<BLACK>(int16_t x, int16_t y);
+template void MicroGamerBase::drawPixel<INVERSE>(int16_t x, int16_t y);
+
+void MicroGamerBase::drawPixel(int16_t x, int16_t y, uint8_t color)
+{
   switch (color)
   {
-    case WHITE:   sBuffer[x+ (y/8)*WIDTH] |=  (1 << (y&7)); break;
-    case BLACK:   sBuffer[x+ (y/8)*WIDTH] &= ~(1 << (y&7)); break;
-    case INVERSE: sBuffer[x+ (y/8)*WIDTH] ^=  (1 << (y&7)); break;
+    case WHITE:   drawPixel<WHITE>(x, y); break;
+    case BLACK:   drawPixel<BLACK>(x, y); break;
+    case INVERSE: drawPixel<INVERSE>(x, y); break;
   }
 }
 
 uint8_t MicroGamerBase::getPixel(uint8_t x, uint8_t y)
 {
-  uint8_t row = y / 8;
-  uint8_t bit_position = y % 8;
-  return (sBuffer[(row*WIDTH) + x] & bit_position) >> bit_position;
+  int16_t sx = x + originX;
+  int16_t sy = y + originY;
+  if (sx < 0 || sx >= WIDTH || sy < 0 || sy >= HEIGHT)
+    return BLACK;
+
+  uint8_t row = sy / 8;
+  uint8_t bit_position = sy % 8;
+  return (sBuffer[(row*WIDTH) + sx] & bit_position) >> bit_position;
 }
 
-void MicroGamerBase::drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
+// Draw the pixels of mask in a byte of the display buffer
+static inline uint8_t colorPixels(uint8_t byte, uint8_t mask, uint8_t color)
+{
+  switch (color)
+  {
+    case WHITE:   return byte | mask;
+    case BLACK:   return byte & ~mask;
+    case INVERSE: return byte ^ mask;
+  }
+  return byte;
+}
+
+// Draw the rows top to bottom of a column on the screen, within the clip
+// rows, a page byte at a time
+static inline void drawColumnSpan(int16_t x, int16_t top, int16_t bottom, uint8_t color)
+{
+  if (top < MicroGamerBase::clipTop)
+    top = MicroGamerBase::clipTop;
+  if (bottom >= MicroGamerBase::clipBottom)
+    bottom = MicroGamerBase::clipBottom - 1;
+  if (top > bottom)
+    return;
+
+  uint8_t page0 = top / 8;
+  uint8_t page1 = bottom / 8;
+  MicroGamerBase::prepareDraw(x, x, page0, page1);
+
+  uint8_t *pBuf = MicroGamerBase::sBuffer + page0 * WIDTH + x;
+  for (uint8_t page = page0; page <= page1; page++)
+  {
+    uint8_t mask = 0xFF;
+    if (page == page0)
+      mask <<= top & 7;
+    if (page == page1)
+      mask &= 0xFF >> (7 - (bottom & 7));
+    *pBuf = colorPixels(*pBuf, mask, color);
+    pBuf += WIDTH;
+  }
+}
+
+// Draw a shape symmetric around (x0, y0), whose columns x0 - d and x0 + d
+// cover the rows y0 - heights[d] to y0 + heights[d], for d from 0 to n.
+// The heights must not increase with d. For an outline, only the pixels
+// of a column which aren't covered by the next one out are drawn, and
+// always the top and bottom ones.
+static void drawSymmetricColumns(int16_t x0, int16_t y0, const uint8_t *heights,
+                                 uint8_t n, bool outline, uint8_t color)
+{
+  for (uint16_t d = 0; d <= n; d++)
+  {
+    int16_t h = heights[d];
+    int16_t inner = 0;
+    if (outline)
+    {
+      inner = d < n ? heights[d + 1] + 1 : 0;
+      if (inner > h)
+        inner = h;
+    }
+
+    for (int16_t x = x0 - d; x <= x0 + d; x += 2 * d)
+    {
+      if (x >= MicroGamerBase::clipLeft && x < MicroGamerBase::clipRight)
+      {
+        if (inner == 0)
+        {
+          drawColumnSpan(x, y0 - h, y0 + h, color);
+        }
+        else
+        {
+          drawColumnSpan(x, y0 - h, y0 - inner, color);
+          drawColumnSpan(x, y0 + inner, y0 + h, color);
+        }
+      }
+      if (d == 0)
+        break;
+    }
+  }
+}
+
+// Get the half heights of the columns of a circle
+static void circleHeights(uint8_t r, uint8_t *heights)
 {
   int16_t f = 1 - r;
   int16_t ddF_x = 1;
@@ -308,12 +545,10 @@ void MicroGamerBase::drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color
   int16_t x = 0;
   int16_t y = r;
 
-  drawPixel(x0, y0+r, color);
-  drawPixel(x0, y0-r, color);
-  drawPixel(x0+r, y0, color);
-  drawPixel(x0-r, y0, color);
+  memset(heights, 0, r + 1);
+  heights[0] = r;
 
-  while (x<y)
+  while (x < y)
   {
     if (f >= 0)
     {
@@ -326,17 +561,100 @@ void MicroGamerBase::drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color
     ddF_x += 2;
     f += ddF_x;
 
-    drawPixel(x0 + x, y0 + y, color);
-    drawPixel(x0 - x, y0 + y, color);
-    drawPixel(x0 + x, y0 - y, color);
-    drawPixel(x0 - x, y0 - y, color);
-    drawPixel(x0 + y, y0 + x, color);
-    drawPixel(x0 - y, y0 + x, color);
-    drawPixel(x0 + y, y0 - x, color);
-    drawPixel(x0 - y, y0 - x, color);
+    // the points of two octants, the others being symmetric
+    if (heights[x] < y)
+      heights[x] = y;
+    if (heights[y] < x)
+      heights[y] = x;
   }
 }
 
+// Get the half heights of the columns of an ellipse, using the algorithm
+// of John Kennedy, "A Fast Bresenham Type Algorithm For Drawing Ellipses"
+static void ellipseHeights(uint8_t rx, uint8_t ry, uint8_t *heights)
+{
+  memset(heights, 0, rx + 1);
+  if (rx == 0 || ry == 0)
+  {
+    heights[0] = ry;
+    return;
+  }
+
+  int32_t twoASquare = 2 * (int32_t)rx * rx;
+  int32_t twoBSquare = 2 * (int32_t)ry * ry;
+  int16_t x = rx;
+  int16_t y = 0;
+  int32_t xChange = (int32_t)ry * ry * (1 - 2 * rx);
+  int32_t yChange = (int32_t)rx * rx;
+  int32_t error = 0;
+  int32_t stoppingX = twoBSquare * rx;
+  int32_t stoppingY = 0;
+
+  // the points where the slope is steeper than 1
+  while (stoppingX >= stoppingY)
+  {
+    if (heights[x] < y)
+      heights[x] = y;
+    y++;
+    stoppingY += twoASquare;
+    error += yChange;
+    yChange += twoASquare;
+    if (2 * error + xChange > 0)
+    {
+      x--;
+      stoppingX -= twoBSquare;
+      error += xChange;
+      xChange += twoBSquare;
+    }
+  }
+
+  // then the others
+  x = 0;
+  y = ry;
+  xChange = (int32_t)ry * ry;
+  yChange = (int32_t)rx * rx * (1 - 2 * ry);
+  error = 0;
+  stoppingX = 0;
+  stoppingY = twoASquare * ry;
+  while (stoppingX <= stoppingY)
+  {
+    if (heights[x] < y)
+      heights[x] = y;
+    x++;
+    stoppingX += twoBSquare;
+    error += xChange;
+    xChange += twoBSquare;
+    if (2 * error + yChange > 0)
+    {
+      y--;
+      stoppingY -= twoASquare;
+      error += yChange;
+      yChange += twoASquare;
+    }
+  }
+
+  // a column can be skipped where the two parts meet
+  for (uint8_t d = rx; d > 0; d--)
+  {
+    if (heights[d - 1] < heights[d])
+      heights[d - 1] = heights[d];
+  }
+}
+
+void MicroGamerBase::drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
+{
+  x0 += originX;
+  y0 += originY;
+
+  // no need to draw at all if we're outside the clip rectangle
+  if (x0 + r < clipLeft || x0 - r >= clipRight || y0 + r < clipTop || y0 - r >= clipBottom)
+    return;
+
+  uint8_t heights[256];
+  circleHeights(r, heights);
+  drawSymmetricColumns(x0, y0, heights, r, true, color);
+}
+
 void MicroGamerBase::drawCircleHelper
 (int16_t x0, int16_t y0, uint8_t r, uint8_t corners, uint8_t color)
 {
@@ -384,8 +702,44 @@ void MicroGamerBase::drawCircleHelper
 
 void MicroGamerBase::fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color)
 {
-  drawFastVLine(x0, y0-r, 2*r+1, color);
-  fillCircleHelper(x0, y0, r, 3, 0, color);
+  x0 += originX;
+  y0 += originY;
+
+  // no need to draw at all if we're outside the clip rectangle
+  if (x0 + r < clipLeft || x0 - r >= clipRight || y0 + r < clipTop || y0 - r >= clipBottom)
+    return;
+
+  uint8_t heights[256];
+  circleHeights(r, heights);
+  drawSymmetricColumns(x0, y0, heights, r, false, color);
+}
+
+void MicroGamerBase::drawEllipse(int16_t x0, int16_t y0, uint8_t rx, uint8_t ry, uint8_t color)
+{
+  x0 += originX;
+  y0 += originY;
+
+  // no need to draw at all if we're outside the clip rectangle
+  if (x0 + rx < clipLeft || x0 - rx >= clipRight || y0 + ry < clipTop || y0 - ry >= clipBottom)
+    return;
+
+  uint8_t heights[256];
+  ellipseHeights(rx, ry, heights);
+  drawSymmetricColumns(x0, y0, heights, rx, true, color);
+}
+
+void MicroGamerBase::fillEllipse(int16_t x0, int16_t y0, uint8_t rx, uint8_t ry, uint8_t color)
+{
+  x0 += originX;
+  y0 += originY;
+
+  // no need to draw at all if we're outside the clip rectangle
+  if (x0 + rx < clipLeft || x0 - rx >= clipRight || y0 + ry < clipTop || y0 - ry >= clipBottom)
+    return;
+
+  uint8_t heights[256];
+  ellipseHeights(rx, ry, heights);
+  drawSymmetricColumns(x0, y0, heights, rx, false, color);
 }
 
 void MicroGamerBase::fillCircleHelper
@@ -425,9 +779,60 @@ void MicroGamerBase::fillCircleHelper
   }
 }
 
+// Apply a pixel mask to a run of bytes of a page of the display buffer.
+// Runs of entire bytes are filled with memset(), which uses word stores.
+static void fillPageColumns(uint8_t *pBuf, uint8_t w, uint8_t mask,
+                            uint8_t color)
+{
+  switch (color)
+  {
+    case WHITE:
+      if (mask == 0xFF) {
+        memset(pBuf, 0xFF, w);
+      } else {
+        while (w--) {
+          *pBuf++ |= mask;
+        }
+      }
+      break;
+
+    case BLACK:
+      if (mask == 0xFF) {
+        memset(pBuf, 0, w);
+      } else {
+        mask = ~mask;
+        while (w--) {
+          *pBuf++ &= mask;
+        }
+      }
+      break;
+
+    case INVERSE:
+      while (w--) {
+        *pBuf++ ^= mask;
+      }
+      break;
+  }
+}
+
+// The first step of a line drawn with Bresenham's algorithm after which the
+// minor coordinate has moved `moves` times. The error term starts at dx / 2
+// and the minor coordinate moves when it becomes negative, so after i steps
+// it has moved ceil((i * dy - dx / 2) / dx) times. The products take up to
+// 32 bits unsigned for lines across the whole int16_t range.
+static int32_t lineStepAfterMoves(int32_t moves, int32_t dx, int32_t dy)
+{
+  return ((int64_t)(moves - 1) * dx + dx / 2) / dy + 1;
+}
+
 void MicroGamerBase::drawLine
 (int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
 {
+  x0 += originX;
+  y0 += originY;
+  x1 += originX;
+  y1 += originY;
+
   // bresenham's algorithm - thx wikpedia
   bool steep = abs(y1 - y0) > abs(x1 - x0);
   if (steep) {
@@ -440,38 +845,100 @@ void MicroGamerBase::drawLine
     swap(y0, y1);
   }
 
-  int16_t dx, dy;
-  dx = x1 - x0;
-  dy = abs(y1 - y0);
+  int32_t dx = x1 - x0;
+  int32_t dy = abs(y1 - y0);
+  int8_t ystep = y0 < y1 ? 1 : -1;
 
-  int16_t err = dx / 2;
-  int8_t ystep;
-
-  if (y0 < y1)
-  {
-    ystep = 1;
-  }
-  else
-  {
-    ystep = -1;
+  // the visible range of x and y, which are swapped for steep lines
+  int16_t xMin, xMax, yMin, yMax;
+  if (steep) {
+    xMin = clipTop;
+    xMax = clipBottom - 1;
+    yMin = clipLeft;
+    yMax = clipRight - 1;
+  } else {
+    xMin = clipLeft;
+    xMax = clipRight - 1;
+    yMin = clipTop;
+    yMax = clipBottom - 1;
   }
 
-  for (; x0 <= x1; x0++)
+  // clip the line up front: the steps within the x range...
+  int32_t first = xMin > x0 ? xMin - x0 : 0;
+  int32_t last = xMax < x1 ? xMax - x0 : dx;
+
+  // ...and those within the y range, from the moves of y reaching it
+  int32_t enter = ystep > 0 ? yMin - y0 : y0 - yMax;
+  int32_t leave = ystep > 0 ? yMax - y0 : y0 - yMin;
+  if (enter > dy || leave < 0)
+    return;
+  if (enter > 0 && lineStepAfterMoves(enter, dx, dy) > first)
+    first = lineStepAfterMoves(enter, dx, dy);
+  if (leave < dy && lineStepAfterMoves(leave + 1, dx, dy) - 1 < last)
+    last = lineStepAfterMoves(leave + 1, dx, dy) - 1;
+  if (first > last)
+    return;
+
+  // the state of the algorithm at the first visible step
+  int64_t moved = (int64_t)first * dy - dx / 2;
+  int32_t moves = moved > 0 ? (moved + dx - 1) / dx : 0;
+  int32_t err = (int64_t)moves * dx - moved;
+  int16_t x = x0 + first;
+  int16_t xEnd = x0 + last;
+  int16_t y = y0 + ystep * moves;
+
+  // only the bytes written are marked as modified, as a partial update of
+  // the bounding box of a diagonal line would send a lot more
+  if (steep)
   {
-    if (steep)
-    {
-      drawPixel(y0, x0, color);
-    }
-    else
+    // a column of pixels for each y, written a page byte at a time
+    uint8_t mask = 0;
+    for (;;)
     {
-      drawPixel(x0, y0, color);
+      mask |= 1 << (x & 7);
+      err -= dy;
+      bool move = err < 0;
+      if (x == xEnd || move || (x & 7) == 7)
+      {
+        prepareDraw(y, y, x / 8, x / 8);
+        fillPageColumns(sBuffer + (x / 8) * WIDTH + y, 1, mask, color);
+        if (x == xEnd)
+          break;
+        mask = 0;
+      }
+      if (move)
+      {
+        y += ystep;
+        err += dx;
+      }
+      x++;
     }
-
-    err -= dy;
-    if (err < 0)
+  }
+  else
+  {
+    // a row of pixels for each y, written as a run of column bytes
+    int16_t runStart = x;
+    for (;;)
     {
-      y0 += ystep;
-      err += dx;
+      bool end = x == xEnd;
+      bool move = false;
+      if (!end)
+      {
+        err -= dy;
+        move = err < 0;
+      }
+      if (end || move)
+      {
+        prepareDraw(runStart, x, y / 8, y / 8);
+        fillPageColumns(sBuffer + (y / 8) * WIDTH + runStart,
+                        x - runStart + 1, 1 << (y & 7), color);
+        if (end)
+          break;
+        y += ystep;
+        err += dx;
+        runStart = x + 1;
+      }
+      x++;
     }
   }
 }
@@ -488,77 +955,349 @@ void MicroGamerBase::drawRect
 void MicroGamerBase::drawFastVLine
 (int16_t x, int16_t y, uint8_t h, uint8_t color)
 {
-  int end = y+h;
-  for (int a = max(0,y); a < min(end,HEIGHT); a++)
-  {
-    drawPixel(x,a,color);
-  }
+  fillRect(x, y, 1, h, color);
 }
 
-void MicroGamerBase::drawFastHLine
-(int16_t x, int16_t y, uint8_t w, uint8_t color)
+template <uint8_t color>
+void MicroGamerBase::drawFastHLine(int16_t x, int16_t y, uint8_t w)
 {
   int16_t xEnd; // last x point + 1
 
+  x += originX;
+  y += originY;
+
   // Do y bounds checks
-  if (y < 0 || y >= HEIGHT)
+  if (y < clipTop || y >= clipBottom)
     return;
 
   xEnd = x + w;
 
-  // Check if the entire line is not on the display
-  if (xEnd <= 0 || x >= WIDTH)
+  // Check if the entire line is outside the clip rectangle
+  if (xEnd <= clipLeft || x >= clipRight)
     return;
 
   // Don't start before the left edge
-  if (x < 0)
-    x = 0;
+  if (x < clipLeft)
+    x = clipLeft;
 
   // Don't end past the right edge
-  if (xEnd > WIDTH)
-    xEnd = WIDTH;
+  if (xEnd > clipRight)
+    xEnd = clipRight;
 
   // calculate actual width (even if unchanged)
   w = xEnd - x;
 
+  prepareDraw(x, xEnd - 1, y / 8, y / 8);
+
   // buffer pointer plus row offset + x offset
-  register uint8_t *pBuf = sBuffer + ((y / 8) * WIDTH) + x;
+  uint8_t *pBuf = sBuffer + ((y / 8) * WIDTH) + x;
 
   // pixel mask
-  register uint8_t mask = 1 << (y & 7);
+  uint8_t mask = 1 << (y & 7);
 
-  switch (color)
+  while (w--)
   {
-    case WHITE:
-      while (w--)
-      {
-        *pBuf++ |= mask;
-      }
-      break;
+    drawPixels<color>(pBuf++, mask);
+  }
+}
 
-    case BLACK:
-      mask = ~mask;
-      while (w--)
-      {
-        *pBuf++ &= mask;
-      }
-      break;
+template void MicroGamerBase::drawFastHLine<WHITE>(int16_t x, int16_t y, uint8_t w);
+template void MicroGamerBase::drawFastHLine<BLACK>(int16_t x, int16_t y, uint8_t w);
+template void MicroGamerBase::drawFastHLine<INVERSE>(int16_t x, int16_t y, uint8_t w);
+
+void MicroGamerBase::drawFastHLine
+(int16_t x, int16_t y, uint8_t w, uint8_t color)
+{
+  switch (color)
+  {
+    case WHITE:   drawFastHLine<WHITE>(x, y, w); break;
+    case BLACK:   drawFastHLine<BLACK>(x, y, w); break;
+    case INVERSE: drawFastHLine<INVERSE>(x, y, w); break;
   }
 }
 
 void MicroGamerBase::fillRect
 (int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
 {
-  // stupidest version - update in subclasses if desired!
-  for (int16_t i=x; i<x+w; i++)
+  x += originX;
+  y += originY;
+
+  int16_t xEnd = x + w; // last x point + 1
+  int16_t yEnd = y + h; // last y point + 1
+
+  // clip to the clip rectangle, or the page being rendered
+  if (x < clipLeft)
+    x = clipLeft;
+  if (xEnd > clipRight)
+    xEnd = clipRight;
+  if (y < clipTop)
+    y = clipTop;
+  if (yEnd > clipBottom)
+    yEnd = clipBottom;
+  if (x >= xEnd || y >= yEnd)
+    return;
+
+  uint8_t firstPage = y / 8;
+  uint8_t lastPage = (yEnd - 1) / 8;
+  w = xEnd - x;
+
+  prepareDraw(x, xEnd - 1, firstPage, lastPage);
+
+  // one run per page, with the pixel masks of the partial top and bottom
+  // pages computed once
+  uint8_t *pBuf = sBuffer + (firstPage * WIDTH) + x;
+  for (uint8_t page = firstPage; page <= lastPage; page++)
   {
-    drawFastVLine(i, y, h, color);
+    uint8_t mask = 0xFF;
+    if (page == firstPage)
+      mask <<= (y & 7);
+    if (page == lastPage)
+      mask &= 0xFF >> (7 - ((yEnd - 1) & 7));
+
+    fillPageColumns(pBuf, w, mask, color);
+    pBuf += WIDTH;
   }
 }
 
+// Fill, or invert, a page of the display buffer with an 8 byte pattern
+// given as two words. Word stores are used if the page is word aligned,
+// which is the case for the library's buffers.
+static void fillPagePattern(uint8_t *pBuf, uint32_t pattern0,
+                            uint32_t pattern1, bool invert)
+{
+  if (((uintptr_t)pBuf & 3) == 0) {
+    uint32_t *pWord = (uint32_t *)pBuf;
+    uint32_t *pEnd = pWord + WIDTH / 4;
+
+    if (invert) {
+      while (pWord < pEnd) {
+        *pWord++ ^= pattern0;
+        *pWord++ ^= pattern1;
+      }
+    } else {
+      while (pWord < pEnd) {
+        *pWord++ = pattern0;
+        *pWord++ = pattern1;
+      }
+    }
+  } else {
+    uint32_t words[2] = {pattern0, pattern1};
+    const uint8_t *pattern = (const uint8_t *)words;
+
+    for (uint8_t i = 0; i < WIDTH; i++) {
+      pBuf[i] = invert ? pBuf[i] ^ pattern[i & 7] : pattern[i & 7];
+    }
+  }
+}
+
+// Fill, or invert, the clip rectangle with an 8 byte pattern, when it
+// doesn't cover whole pages
+static void fillClipPattern(const uint8_t *pattern, bool invert)
+{
+  int16_t left = MicroGamerBase::clipLeft;
+  int16_t right = MicroGamerBase::clipRight;
+
+  for (uint8_t page = MicroGamerBase::clipTop / 8;
+       page < (MicroGamerBase::clipBottom + 7) / 8; page++) {
+    uint8_t mask = MicroGamerBase::clipMask(page);
+    uint8_t *pBuf = MicroGamerBase::sBuffer + page * WIDTH;
+
+    MicroGamerBase::prepareDraw(left, right - 1, page, page);
+    for (int16_t x = left; x < right; x++) {
+      uint8_t bits = pattern[x & 7] & mask;
+      pBuf[x] = invert ? pBuf[x] ^ bits : (pBuf[x] & ~mask) | bits;
+    }
+  }
+}
+
+// Whether the clip rectangle is made of whole pages of the display
+static inline bool clipIsPages()
+{
+  return MicroGamerBase::clipLeft == 0 && MicroGamerBase::clipRight == WIDTH &&
+         ((MicroGamerBase::clipTop | MicroGamerBase::clipBottom) & 7) == 0;
+}
+
 void MicroGamerBase::fillScreen(uint8_t color)
 {
-    memset(sBuffer, 0, WIDTH*HEIGHT/8);
+  uint32_t pattern = color == BLACK ? 0 : 0xFFFFFFFF;
+
+  if (!clipIsPages()) {
+    uint8_t bytes[8];
+    memset(bytes, pattern & 0xFF, sizeof(bytes));
+    fillClipPattern(bytes, color == INVERSE);
+    return;
+  }
+
+  // page by page, following the transfer of the buffer if there is one
+  for (uint8_t page = clipTop / 8; page < (clipBottom + 7) / 8; page++) {
+    prepareDraw(0, WIDTH - 1, page, page);
+    fillPagePattern(sBuffer + page * WIDTH, pattern, pattern,
+                    color == INVERSE);
+  }
+}
+
+void MicroGamerBase::fillScreenPattern(const uint8_t *pattern)
+{
+  uint8_t bytes[8];
+  uint32_t pattern0, pattern1;
+
+  for (uint8_t i = 0; i < 8; i++) {
+    bytes[i] = pgm_read_byte(pattern + i);
+  }
+  // in memory order, whatever the byte order of the words
+  memcpy(&pattern0, bytes, 4);
+  memcpy(&pattern1, bytes + 4, 4);
+
+  if (!clipIsPages()) {
+    fillClipPattern(bytes, false);
+    return;
+  }
+
+  for (uint8_t page = clipTop / 8; page < (clipBottom + 7) / 8; page++) {
+    prepareDraw(0, WIDTH - 1, page, page);
+    fillPagePattern(sBuffer + page * WIDTH, pattern0, pattern1, false);
+  }
+}
+
+// Shift 4 (or 1) adjacent columns of a page down by shift bits, the bits
+// from the page above (`prev`) coming in at the top, each byte being
+// shifted separately. `shift` is 1 to 7.
+static inline uint32_t shiftDown(uint32_t cur, uint32_t prev, uint8_t shift)
+{
+  uint32_t keep = ((0xFF << shift) & 0xFF) * 0x01010101UL;
+  return ((cur << shift) & keep) | ((prev >> (8 - shift)) & ~keep);
+}
+
+// The same, shifting up with the bits from the page below (`next`)
+static inline uint32_t shiftUp(uint32_t cur, uint32_t next, uint8_t shift)
+{
+  uint32_t keep = (0xFF >> shift) * 0x01010101UL;
+  return ((cur >> shift) & keep) | ((next << (8 - shift)) & ~keep);
+}
+
+// Shift the columns left to left + width - 1 of the pages firstPage to
+// endPage - 1 down by dy pixels, or up if negative
+static void scrollRows(int16_t firstPage, int16_t endPage, int16_t left,
+                       uint8_t width, int8_t dy, uint8_t fillByte)
+{
+  uint8_t *sBuffer = MicroGamerBase::sBuffer + left;
+
+  // whole pages are moved and each byte is combined from two pages for the
+  // remaining bits, a word of 4 columns at a time when the columns are
+  // word aligned
+  int16_t pageShift = abs(dy) / 8;
+  uint8_t shift = abs(dy) % 8;
+  bool words = (((uintptr_t)sBuffer | width) & 3) == 0;
+  uint8_t step = words ? 4 : 1;
+  uint32_t fillWord = fillByte * 0x01010101UL;
+
+  for (int16_t i = 0; i < endPage - firstPage; i++) {
+    // down: from the bottom page up, reading the pages above
+    // up: from the top page down, reading the pages below
+    int16_t page = dy > 0 ? endPage - 1 - i : firstPage + i;
+    int16_t from = dy > 0 ? page - pageShift : page + pageShift;
+    int16_t carry = dy > 0 ? from - 1 : from + 1;
+    bool fromIn = from >= firstPage && from < endPage;
+    bool carryIn = carry >= firstPage && carry < endPage;
+    uint8_t *pBuf = sBuffer + page * WIDTH;
+
+    if (shift == 0) {
+      if (fromIn) {
+        memcpy(pBuf, sBuffer + from * WIDTH, width);
+      } else {
+        memset(pBuf, fillByte, width);
+      }
+      continue;
+    }
+
+    for (uint8_t x = 0; x < width; x += step) {
+      uint32_t cur, adjacent, out;
+
+      if (words) {
+        cur = fromIn ? *(uint32_t *)(sBuffer + from * WIDTH + x) : fillWord;
+        adjacent = carryIn ? *(uint32_t *)(sBuffer + carry * WIDTH + x) : fillWord;
+      } else {
+        cur = fromIn ? sBuffer[from * WIDTH + x] : fillByte;
+        adjacent = carryIn ? sBuffer[carry * WIDTH + x] : fillByte;
+      }
+
+      if (dy > 0) {
+        out = shiftDown(cur, adjacent, shift);
+      } else {
+        out = shiftUp(cur, adjacent, shift);
+      }
+
+      if (words) {
+        *(uint32_t *)(pBuf + x) = out;
+      } else {
+        pBuf[x] = out;
+      }
+    }
+  }
+}
+
+void MicroGamerBase::scroll(int8_t dx, int8_t dy, uint8_t fill)
+{
+  int16_t firstPage = clipTop / 8;
+  int16_t endPage = (clipBottom + 7) / 8;
+  int16_t left = clipLeft;
+  uint8_t width = clipRight - clipLeft;
+
+  if (endPage <= firstPage || (dx == 0 && dy == 0)) {
+    return;
+  }
+
+  uint8_t fillByte = fill == BLACK ? 0 : 0xFF;
+  uint8_t distance = abs(dx) < width ? abs(dx) : width;
+
+  prepareDraw(left, clipRight - 1, firstPage, endPage - 1);
+
+  // the rows of the first and last pages outside of the clip rectangle are
+  // put aside, and filled so that what scrolls in from there is the fill
+  // color, as from outside of the display
+  uint8_t topMask = clipMask(firstPage);
+  uint8_t bottomMask = clipMask(endPage - 1);
+  uint8_t *top = sBuffer + firstPage * WIDTH + left;
+  uint8_t *bottom = sBuffer + (endPage - 1) * WIDTH + left;
+  uint8_t topKept[WIDTH];
+  uint8_t bottomKept[WIDTH];
+  bool partial = topMask != 0xFF || bottomMask != 0xFF;
+
+  if (partial) {
+    for (uint8_t x = 0; x < width; x++) {
+      topKept[x] = top[x];
+      top[x] = (top[x] & topMask) | (fillByte & ~topMask);
+      bottomKept[x] = bottom[x];
+      bottom[x] = (bottom[x] & bottomMask) | (fillByte & ~bottomMask);
+    }
+  }
+
+  if (dx != 0) {
+    // horizontally the columns of each page are moved as a whole
+    for (int16_t page = firstPage; page < endPage; page++) {
+      uint8_t *pBuf = sBuffer + page * WIDTH + left;
+      if (dx > 0) {
+        memmove(pBuf + distance, pBuf, width - distance);
+        memset(pBuf, fillByte, distance);
+      } else {
+        memmove(pBuf, pBuf + distance, width - distance);
+        memset(pBuf + width - distance, fillByte, distance);
+      }
+    }
+  }
+
+  if (dy != 0) {
+    scrollRows(firstPage, endPage, left, width, dy, fillByte);
+  }
+
+  // the bottom page first, as the top one holds the original bytes when
+  // they're the same page
+  if (partial) {
+    for (uint8_t x = 0; x < width; x++) {
+      bottom[x] = (bottom[x] & bottomMask) | (bottomKept[x] & ~bottomMask);
+      top[x] = (top[x] & topMask) | (topKept[x] & ~topMask);
+    }
+  }
 }
 
 void MicroGamerBase::drawRoundRect
@@ -598,156 +1337,183 @@ void MicroGamerBase::drawTriangle
 void MicroGamerBase::fillTriangle
 (int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
 {
+  Point corners[3] = { { x0, y0 }, { x1, y1 }, { x2, y2 } };
 
-  int16_t a, b, y, last;
-  // Sort coordinates by Y order (y2 >= y1 >= y0)
-  if (y0 > y1)
-  {
-    swap(y0, y1); swap(x0, x1);
-  }
-  if (y1 > y2)
-  {
-    swap(y2, y1); swap(x2, x1);
-  }
-  if (y0 > y1)
-  {
-    swap(y0, y1); swap(x0, x1);
-  }
+  fillPolygon(corners, 3, color);
+}
 
-  if(y0 == y2)
-  { // Handle awkward all-on-same-line case as its own thing
-    a = b = x0;
-    if(x1 < a)
-    {
-      a = x1;
-    }
-    else if(x1 > b)
-    {
-      b = x1;
-    }
-    if(x2 < a)
-    {
-      a = x2;
-    }
-    else if(x2 > b)
-    {
-      b = x2;
-    }
-    drawFastHLine(a, y0, b-a+1, color);
+// An edge of a polygon, crossing the rows y to yEnd - 1. It can cross the
+// whole int16_t range of X coordinates in a row, so the values are 32.32
+// fixed point. Over up to 65535 rows, the rounding of
+// the slope then stays below 1/65536 of a pixel, less than the fraction of
+// any exact position that isn't a whole pixel, so the pixels are exact.
+struct PolygonEdge
+{
+  int64_t x;     // X coordinate at the current row, in 32.32 fixed point
+  int64_t slope; // change of x from a row to the next, in 32.32 fixed point
+  int16_t yEnd;
+};
+
+// Set an edge from the corners a to b, at row y. The slope is rounded down,
+// so that x is never to the right of the exact value.
+static void setPolygonEdge(PolygonEdge &edge, const Point &a, const Point &b,
+                           int16_t y)
+{
+  // multiplied rather than shifted, as the values can be negative
+  int64_t dx = (int64_t)(b.x - a.x) * 0x100000000LL;
+  int32_t dy = b.y - a.y;
+
+  edge.slope = dx >= 0 ? dx / dy : -((dy - 1 - dx) / dy);
+  edge.x = (int64_t)a.x * 0x100000000LL + edge.slope * (y - a.y);
+  edge.yEnd = b.y;
+}
+
+void MicroGamerBase::fillPolygon(const Point *corners, uint8_t count, uint8_t color)
+{
+  if (count < 3)
     return;
-  }
 
-  int16_t dx01 = x1 - x0,
-      dy01 = y1 - y0,
-      dx02 = x2 - x0,
-      dy02 = y2 - y0,
-      dx12 = x2 - x1,
-      dy12 = y2 - y1,
-      sa = 0,
-      sb = 0;
-
-  // For upper part of triangle, find scanline crossings for segments
-  // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
-  // is included here (and second loop will be skipped, avoiding a /0
-  // error there), otherwise scanline y1 is skipped here and handled
-  // in the second loop...which also avoids a /0 error here if y0=y1
-  // (flat-topped triangle).
-  if (y1 == y2)
-  {
-    last = y1;   // Include y1 scanline
-  }
-  else
+  // the top and bottom corners, where the two sides start and end
+  uint8_t top = 0;
+  uint8_t bottom = 0;
+  for (uint8_t i = 1; i < count; i++)
   {
-    last = y1-1; // Skip it
+    if (corners[i].y < corners[top].y)
+      top = i;
+    if (corners[i].y > corners[bottom].y)
+      bottom = i;
   }
 
-
-  for(y = y0; y <= last; y++)
+  // the clip rectangle in the coordinates of the corners, which stay
+  // relative to the viewport, as drawFastHLine() moves the spans
+  int16_t left = clipLeft - originX;
+  int16_t right = clipRight - originX;
+
+  // the rows from the top corner to the one above the bottom corner
+  int16_t y = corners[top].y;
+  int16_t yEnd = corners[bottom].y;
+  if (y < clipTop - originY)
+    y = clipTop - originY;
+  if (yEnd > clipBottom - originY)
+    yEnd = clipBottom - originY;
+
+  // the sides going around the polygon in each direction, with the corner
+  // at the end of their current edge
+  PolygonEdge edgeA = { 0, 0, corners[top].y };
+  PolygonEdge edgeB = edgeA;
+  uint8_t cornerA = top;
+  uint8_t cornerB = top;
+
+  for (; y < yEnd; y++)
   {
-    a   = x0 + sa / dy01;
-    b   = x0 + sb / dy02;
-    sa += dx01;
-    sb += dx02;
-
-    if(a > b)
+    // move on to the edges crossing this row, skipping horizontal ones
+    while (edgeA.yEnd <= y)
     {
-      swap(a,b);
+      uint8_t next = cornerA + 1 < count ? cornerA + 1 : 0;
+      if (corners[next].y > y)
+        setPolygonEdge(edgeA, corners[cornerA], corners[next], y);
+      else
+        edgeA.yEnd = corners[next].y;
+      cornerA = next;
     }
-
-    drawFastHLine(a, y, b-a+1, color);
-  }
-
-  // For lower part of triangle, find scanline crossings for segments
-  // 0-2 and 1-2.  This loop is skipped if y1=y2.
-  sa = dx12 * (y - y1);
-  sb = dx02 * (y - y0);
-
-  for(; y <= y2; y++)
-  {
-    a   = x1 + sa / dy12;
-    b   = x0 + sb / dy02;
-    sa += dx12;
-    sb += dx02;
-
-    if(a > b)
+    while (edgeB.yEnd <= y)
     {
-      swap(a,b);
+      uint8_t next = cornerB > 0 ? cornerB - 1 : count - 1;
+      if (corners[next].y > y)
+        setPolygonEdge(edgeB, corners[cornerB], corners[next], y);
+      else
+        edgeB.yEnd = corners[next].y;
+      cornerB = next;
     }
 
-    drawFastHLine(a, y, b-a+1, color);
+    // the pixels from the left edge, included, to the right edge, excluded,
+    // rounding both up, so that polygons sharing an edge don't overlap
+    int32_t a = (edgeA.x + 0xFFFFFFFF) >> 32;
+    int32_t b = (edgeB.x + 0xFFFFFFFF) >> 32;
+    if (a > b)
+    {
+      int32_t t = a;
+      a = b;
+      b = t;
+    }
+    if (a < left)
+      a = left;
+    if (b > right)
+      b = right;
+    if (a < b)
+      drawFastHLine(a, y, b - a, color);
+
+    edgeA.x += edgeA.slope;
+    edgeB.x += edgeB.slope;
   }
 }
 
+template <uint8_t color>
 void MicroGamerBase::drawBitmap
-(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h,
- uint8_t color)
+(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h)
 {
-  // no need to draw at all if we're offscreen
-  if (x+w < 0 || x > WIDTH-1 || y+h < 0 || y > HEIGHT-1)
-    return;
+  x += originX;
+  y += originY;
 
-  int yOffset = abs(y) % 8;
-  int sRow = y / 8;
-  if (y < 0) {
-    sRow--;
-    yOffset = 8 - yOffset;
-  }
   int rows = h/8;
   if (h%8!=0) rows++;
+
+  // no need to draw at all if we're outside the clip rectangle, whole
+  // bytes of the bitmap being drawn
+  if (!prepareDrawRect(x, y, w, rows * 8))
+    return;
+
+  // the columns of the bitmap within the clip rectangle
+  int16_t colStart = x < clipLeft ? clipLeft - x : 0;
+  int16_t colEnd = x + w > clipRight ? clipRight - x : w;
+
+  int firstPage = clipTop / 8;
+  int lastPage = (clipBottom - 1) / 8;
+  int yOffset = y & 7;
+  int sRow = (y - yOffset) / 8;
   for (int a = 0; a < rows; a++) {
     int bRow = sRow + a;
-    if (bRow > (HEIGHT/8)-1) break;
-    if (bRow > -2) {
-      for (int iCol = 0; iCol<w; iCol++) {
-        if (iCol + x > (WIDTH-1)) break;
-        if (iCol + x >= 0) {
-          if (bRow >= 0) {
-            if (color == WHITE)
-              sBuffer[(bRow*WIDTH) + x + iCol] |= pgm_read_byte(bitmap+(a*w)+iCol) << yOffset;
-            else if (color == BLACK)
-              sBuffer[(bRow*WIDTH) + x + iCol] &= ~(pgm_read_byte(bitmap+(a*w)+iCol) << yOffset);
-            else
-              sBuffer[(bRow*WIDTH) + x + iCol] ^= pgm_read_byte(bitmap+(a*w)+iCol) << yOffset;
-          }
-          if (yOffset && bRow<(HEIGHT/8)-1 && bRow > -2) {
-            if (color == WHITE)
-              sBuffer[((bRow+1)*WIDTH) + x + iCol] |= pgm_read_byte(bitmap+(a*w)+iCol) >> (8-yOffset);
-            else if (color == BLACK)
-              sBuffer[((bRow+1)*WIDTH) + x + iCol] &= ~(pgm_read_byte(bitmap+(a*w)+iCol) >> (8-yOffset));
-            else
-              sBuffer[((bRow+1)*WIDTH) + x + iCol] ^= pgm_read_byte(bitmap+(a*w)+iCol) >> (8-yOffset);
-          }
-        }
+    if (bRow > lastPage) break;
+    if (bRow > firstPage - 2) {
+      // the rows of the two pages the bitmap row is drawn on which are
+      // within the clip rectangle
+      uint8_t mask = bRow >= firstPage ? clipMask(bRow) : 0;
+      uint8_t nextMask = yOffset && bRow < lastPage ? clipMask(bRow + 1) : 0;
+      const uint8_t *src = bitmap + (a * w);
+      for (int iCol = colStart; iCol < colEnd; iCol++) {
+        uint8_t bits = pgm_read_byte(src + iCol);
+        if (mask)
+          drawPixels<color>(&sBuffer[(bRow*WIDTH) + x + iCol], (bits << yOffset) & mask);
+        if (nextMask)
+          drawPixels<color>(&sBuffer[((bRow+1)*WIDTH) + x + iCol], (bits >> (8-yOffset)) & nextMask);
       }
     }
   }
 }
 
+template void MicroGamerBase::drawBitmap<WHITE>(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h);
+template void MicroGamerBase::drawBitmap<BLACK>(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h);
+template void MicroGamerBase::drawBitmap<INVERSE>(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h);
+
+void MicroGamerBase::drawBitmap
+(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h,
+ uint8_t color)
+{
+  switch (color)
+  {
+    case WHITE: drawBitmap<WHITE>(x, y, bitmap, w, h); break;
+    case BLACK: drawBitmap<BLACK>(x, y, bitmap, w, h); break;
+    default:    drawBitmap<INVERSE>(x, y, bitmap, w, h); break;
+  }
+}
+
 void MicroGamerBase::drawSlowXYBitmap
 (int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color)
 {
-  // no need to draw at all of we're offscreen
-  if (x+w < 0 || x > WIDTH-1 || y+h < 0 || y > HEIGHT-1)
+  // no need to draw at all of we're outside the clip rectangle
+  int16_t sx = x + originX;
+  int16_t sy = y + originY;
+  if (sx+w <= clipLeft || sx >= clipRight || sy+h <= clipTop || sy >= clipBottom)
     return;
 
   int16_t xi, yi, byteWidth = (w + 7) / 8;
@@ -760,131 +1526,175 @@ void MicroGamerBase::drawSlowXYBitmap
   }
 }
 
-typedef struct CSESSION {
-  int byte;
-  int bit;
-  const uint8_t *src;
-  int src_pos;
-} CSESSION;
-static CSESSION cs;
+// State of the decoding of a compressed bitmap. It's kept by the caller, so
+// that drawCompressed() is reentrant.
+struct CompressedReader
+{
+  const uint8_t *src; // next byte to read
+  uint32_t bits;      // bits read but not used yet, the next one in bit 0
+  uint8_t count;      // number of bits in `bits`
+};
 
-static int getval(int bits)
+// Get the next `count` bits, 0 to 24, the first one in bit 0 of the value
+static inline uint32_t readBits(CompressedReader &in, uint8_t count)
 {
-  int val = 0;
-  int i;
-  for (i = 0; i < bits; i++)
-  {
-    if (cs.bit == 0x100)
-    {
-      cs.bit = 0x1;
-      cs.byte = pgm_read_byte(&cs.src[cs.src_pos]);
-      cs.src_pos ++;
+  // whole bytes are added as needed
+  while (in.count < count) {
+    in.bits |= (uint32_t)pgm_read_byte(in.src++) << in.count;
+    in.count += 8;
+  }
+  uint32_t value = in.bits & ((1UL << count) - 1);
+  in.bits >>= count;
+  in.count -= count;
+  return value;
+}
+
+// Get the number of 0 bits before the next 1 bit, and skip them and the 1
+static inline uint8_t readZeros(CompressedReader &in)
+{
+  uint8_t zeros = 0;
+
+  for (;;) {
+    if (in.count == 0) {
+      in.bits = pgm_read_byte(in.src++);
+      in.count = 8;
+    }
+    if (in.bits != 0) {
+      uint8_t run = __builtin_ctz(in.bits);
+      in.bits >>= run + 1;
+      in.count -= run + 1;
+      return zeros + run;
     }
-    if (cs.byte & cs.bit)
-      val += (1 << i);
-    cs.bit <<= 1;
+    // only zeros left
+    zeros += in.count;
+    in.count = 0;
   }
-  return val;
 }
 
-void MicroGamerBase::drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitmap, uint8_t color)
+// Draw a decoded byte of a compressed bitmap, at page `bRow` (which can be
+// the one above the first page drawn) and shifted down by yOffset pixels
+static inline void drawCompressedByte(int16_t bRow, int16_t x, uint8_t byte,
+                                      uint8_t yOffset, int16_t firstPage,
+                                      int16_t lastPage, uint8_t color)
 {
-  int bl, len;
-  int col;
-  int i;
-  int a, iCol;
-  int byte = 0;
-  int bit = 0;
-  int w, h;
+  if (x < MicroGamerBase::clipLeft || x >= MicroGamerBase::clipRight ||
+      bRow > lastPage || bRow < firstPage - 1) {
+    return;
+  }
 
-  // set up decompress state
+  uint16_t bits = byte << yOffset;
+  uint8_t *sBuffer = MicroGamerBase::sBuffer;
 
-  cs.src = bitmap;
-  cs.bit = 0x100;
-  cs.byte = 0;
-  cs.src_pos = 0;
+  if (bRow >= firstPage) {
+    uint8_t mask = bits & MicroGamerBase::clipMask(bRow);
+    if (color == WHITE)
+      sBuffer[(bRow * WIDTH) + x] |= mask;
+    else if (color == BLACK)
+      sBuffer[(bRow * WIDTH) + x] &= ~mask;
+    else
+      sBuffer[(bRow * WIDTH) + x] ^= mask;
+  }
+  if (yOffset && bRow < lastPage) {
+    uint8_t mask = (bits >> 8) & MicroGamerBase::clipMask(bRow + 1);
+    if (color == WHITE)
+      sBuffer[((bRow + 1) * WIDTH) + x] |= mask;
+    else if (color == BLACK)
+      sBuffer[((bRow + 1) * WIDTH) + x] &= ~mask;
+    else
+      sBuffer[((bRow + 1) * WIDTH) + x] ^= mask;
+  }
+}
+
+void MicroGamerBase::drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitmap, uint8_t color)
+{
+  CompressedReader in = { bitmap, 0, 0 };
 
   // read header
 
-  w = getval(8) + 1;
-  h = getval(8) + 1;
+  int w = readBits(in, 8) + 1;
+  int h = readBits(in, 8) + 1;
+
+  uint8_t col = readBits(in, 1); // starting colour
 
-  col = getval(1); // starting colour
+  sx += originX;
+  sy += originY;
 
-  // no need to draw at all if we're offscreen
-  if (sx + w < 0 || sx > WIDTH - 1 || sy + h < 0 || sy > HEIGHT - 1)
+  // no need to draw at all if we're outside the clip rectangle
+  if (!prepareDrawRect(sx, sy, w, h))
     return;
 
-  // sy = sy - (frame*h);
+  int firstPage = clipTop / 8;
+  int lastPage = (clipBottom - 1) / 8;
 
-  int yOffset = abs(sy) % 8;
-  int sRow = sy / 8;
-  if (sy < 0) {
-    sRow--;
-    yOffset = 8 - yOffset;
-  }
+  int yOffset = sy & 7;
+  int sRow = (sy - yOffset) / 8;
   int rows = h / 8;
   if (h % 8 != 0) rows++;
 
-  a = 0; // +(frame*rows);
-  iCol = 0;
+  int a = 0; // row of bytes
+  int iCol = 0;
+  uint8_t byte = 0; // byte being decoded, and the number of its bits so far
+  uint8_t bit = 0;
 
-  byte = 0; bit = 1;
-  while (a < rows) // + (frame*rows))
+  while (a < rows)
   {
-    bl = 1;
-    while (!getval(1))
-      bl += 2;
+    // span length, as an Elias gamma code: the number of zeros before
+    // the first 1 gives the number of bits of the length
+    uint8_t bl = readZeros(in) * 2 + 1;
+    uint32_t len = readBits(in, bl) + 1;
 
-    len = getval(bl) + 1; // span length
-
-    // draw the span
-
-
-    for (i = 0; i < len; i++)
+    while (len > 0 && a < rows)
     {
+      // the bits of the span which go into the current byte at once
+      uint8_t n = len < (uint32_t)(8 - bit) ? len : 8 - bit;
       if (col)
-        byte |= bit;
-      bit <<= 1;
+        byte |= ((1 << n) - 1) << bit;
+      bit += n;
+      len -= n;
 
-      if (bit == 0x100) // reached end of byte
+      if (bit == 8) // reached end of byte
       {
-        // draw
-
-        int bRow = sRow + a;
-
-        //if (byte) // possible optimisation
-        if (bRow <= (HEIGHT / 8) - 1)
-          if (bRow > -2)
-            if (iCol + sx <= (WIDTH - 1))
-              if (iCol + sx >= 0) {
-
-                if (bRow >= 0)
-                {
-                  if (color)
-                    sBuffer[(bRow * WIDTH) + sx + iCol] |= byte << yOffset;
-                  else
-                    sBuffer[(bRow * WIDTH) + sx + iCol] &= ~(byte << yOffset);
-                }
-                if (yOffset && bRow < (HEIGHT / 8) - 1 && bRow > -2)
-                {
-                  if (color)
-                    sBuffer[((bRow + 1)*WIDTH) + sx + iCol] |= byte >> (8 - yOffset);
-                  else
-                    sBuffer[((bRow + 1)*WIDTH) + sx + iCol] &= ~(byte >> (8 - yOffset));
-                }
-              }
-
-        // iterate
-        iCol ++;
-        if (iCol >= w)
+        // only the set bits are drawn
+        if (byte)
+          drawCompressedByte(sRow + a, sx + iCol, byte, yOffset,
+                             firstPage, lastPage, color);
+        if (++iCol >= w)
         {
           iCol = 0;
-          a ++;
+          a++;
         }
+        byte = 0; bit = 0;
 
-        // reset byte
-        byte = 0; bit = 1;
+        // then whole bytes of the span
+        if (len >= 8)
+        {
+          uint32_t bytes = len / 8;
+          len -= bytes * 8;
+          if (col)
+          {
+            for (; bytes > 0 && a < rows; bytes--)
+            {
+              drawCompressedByte(sRow + a, sx + iCol, 0xFF, yOffset,
+                                 firstPage, lastPage, color);
+              if (++iCol >= w)
+              {
+                iCol = 0;
+                a++;
+              }
+            }
+          }
+          else
+          {
+            // nothing to draw, skip them
+            iCol += bytes % w;
+            a += bytes / w;
+            if (iCol >= w)
+            {
+              iCol -= w;
+              a++;
+            }
+          }
+        }
       }
     }
 
@@ -892,20 +1702,121 @@ void MicroGamerBase::drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitma
   }
 }
 
+void MicroGamerBase::decompress(uint8_t *dest, const uint8_t *bitmap)
+{
+  CompressedReader in = { bitmap, 0, 0 };
+
+  int w = readBits(in, 8) + 1;
+  int h = readBits(in, 8) + 1;
+  uint8_t col = readBits(in, 1);
+
+  // the bytes come in the order of drawBitmap() arrays
+  uint8_t *end = dest + w * ((h + 7) / 8);
+  uint8_t byte = 0;
+  uint8_t bit = 0;
+
+  while (dest < end)
+  {
+    uint8_t bl = readZeros(in) * 2 + 1;
+    uint32_t len = readBits(in, bl) + 1;
+
+    // the bits of the span completing the current byte
+    uint8_t n = len < (uint32_t)(8 - bit) ? len : 8 - bit;
+    if (col)
+      byte |= ((1 << n) - 1) << bit;
+    bit += n;
+    len -= n;
+
+    if (bit == 8)
+    {
+      *dest++ = byte;
+
+      // then whole bytes
+      uint32_t bytes = len / 8;
+      if (bytes > (uint32_t)(end - dest))
+        bytes = end - dest;
+      memset(dest, col ? 0xFF : 0, bytes);
+      dest += bytes;
+
+      // and the start of the next one
+      bit = len % 8;
+      byte = col ? (1 << bit) - 1 : 0;
+    }
+
+    col = 1 - col;
+  }
+}
+
 void MicroGamerBase::display()
 {
-  uint8_t *tmp;
+#ifdef STRIP_RENDERING_ONLY
+  displayStrips();
+#else
+  if (stripRenderer != NULL) {
+    displayStrips();
+    return;
+  }
+
+  if (displayBufferCount > 1) {
+    queuePaintScreen(sBuffer);
+
+    // continue with the next buffer of the ring, once the frame that was
+    // queued in it has been sent
+    if (++displayBufferIndex == displayBufferCount) {
+      displayBufferIndex = 0;
+    }
+    sBuffer = displayBufferIndex == 0 ? staticAllocatedBuffer :
+      displayBuffers + (displayBufferIndex - 1) * (WIDTH * HEIGHT / 8);
+    while (paintScreensPending() >= displayBufferCount) {
+      idle();
+    }
+    return;
+  }
 
   waitEndOfPaintScreen();
 
-  if(displayBuffer != NULL) {
-    tmp = displayBuffer;
-    displayBuffer = sBuffer;
-    sBuffer = tmp;
-    paintScreen(displayBuffer);
+  if (partialUpdates) {
+    paintScreenDirty(sBuffer);
   } else {
-      paintScreen(sBuffer);
+    paintScreen(sBuffer);
   }
+#endif
+}
+
+void MicroGamerBase::displayStrips()
+{
+  uint8_t *frameBuffer = sBuffer;
+  int16_t top = stripTop;
+  int16_t bottom = stripBottom;
+
+  for (uint8_t page = 0; page < HEIGHT/8; page++) {
+    uint8_t *strip = staticAllocatedBuffer + (page & 1) * WIDTH;
+
+    // wait for the strip to be free: page 0 waits for the previous frame
+    if (page == 0) {
+      waitEndOfPaintScreen();
+    } else if (page >= 2) {
+      waitForPage(page - 2);
+    }
+
+    // point the buffer so that the page is drawn in the strip
+    sBuffer = strip - page * WIDTH;
+    stripTop = page * 8;
+    stripBottom = stripTop + 8;
+    updateClip();
+    memset(strip, 0, WIDTH);
+
+    if (stripRenderer != NULL) {
+      (*stripRenderer)(page);
+    }
+
+    paintScreenPage(strip, page);
+  }
+
+  sBuffer = frameBuffer;
+  stripTop = top;
+  stripBottom = bottom;
+  updateClip();
 }
 
 void MicroGamerBase::display(bool clear)
@@ -923,14 +1834,86 @@ void MicroGamerBase::waitDisplayUpdate()
 
 void MicroGamerBase::enableDoubleBuffer()
 {
-  if(displayBuffer == NULL) {
-    displayBuffer = (uint8_t *) malloc(((HEIGHT * WIDTH) / 8) * sizeof(uint8_t));
+#ifndef STRIP_RENDERING_ONLY
+  if(displayBufferCount == 1) {
+    uint8_t *buffer = (uint8_t *) malloc(((HEIGHT * WIDTH) / 8) * sizeof(uint8_t));
+    if (buffer != NULL) {
+      setDisplayBuffers(buffer, 1);
+    }
   }
+#endif
+}
+
+void MicroGamerBase::setDisplayBuffers(uint8_t *buffers, uint8_t count)
+{
+#ifndef STRIP_RENDERING_ONLY
+  // the ring restarts with the static buffer, once nothing is being sent
+  waitEndOfPaintScreen();
+  sBuffer = staticAllocatedBuffer;
+  displayBuffers = buffers;
+  displayBufferCount = buffers == NULL ? 1 : count + 1;
+  displayBufferIndex = 0;
+#endif
 }
 
 bool MicroGamerBase::doubleBuffer()
 {
-  return displayBuffer != NULL;
+  return displayBufferCount > 1;
+}
+
+void MicroGamerBase::setPartialUpdate(bool enable)
+{
+  partialUpdates = enable;
+}
+
+bool MicroGamerBase::partialUpdate()
+{
+  return partialUpdates;
+}
+
+void MicroGamerBase::setScrollY(uint8_t y)
+{
+  scrollOffset = y & (HEIGHT - 1);
+  setStartLine(scrollOffset);
+}
+
+uint8_t MicroGamerBase::scrollY()
+{
+  return scrollOffset;
+}
+
+uint8_t MicroGamerBase::bufferY(int16_t y)
+{
+  return (y + scrollOffset) & (HEIGHT - 1);
+}
+
+void MicroGamerBase::setStripRenderer(void (*renderer)(uint8_t page))
+{
+  if (stripRenderer != NULL && renderer == NULL) {
+    // the display no longer matches the display buffer
+    markAllDirty();
+  }
+  stripRenderer = renderer;
+}
+
+void MicroGamerBase::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t xEnd = x + w - 1;
+  int16_t yEnd = y + h - 1;
+
+  if (w <= 0 || h <= 0 || xEnd < 0 || x >= WIDTH || yEnd < 0 || y >= HEIGHT)
+    return;
+
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (xEnd >= WIDTH)
+    xEnd = WIDTH - 1;
+  if (yEnd >= HEIGHT)
+    yEnd = HEIGHT - 1;
+
+  prepareDraw(x, xEnd, y / 8, yEnd / 8);
 }
 
 uint8_t* MicroGamerBase::getBuffer()
@@ -1134,7 +2117,7 @@ size_t MicroGamer::write(uint8_t c)
   {
     drawChar(cursor_x, cursor_y, c, textColor, textBackground, textSize);
     cursor_x += textSize * 6;
-    if (textWrap && (cursor_x > (WIDTH - textSize * 6)))
+    if (textWrap && (cursor_x > (clipRect.right - originX - textSize * 6)))
     {
       // calling ourselves recursively for 'newline' is
       // 12 bytes smaller than doing the same math here
@@ -1147,38 +2130,105 @@ size_t MicroGamer::write(uint8_t c)
 void MicroGamer::drawChar
   (int16_t x, int16_t y, unsigned char c, uint8_t color, uint8_t bg, uint8_t size)
 {
-  uint8_t line;
   bool draw_background = bg != color;
   const unsigned char* bitmap = font + c * 5;
 
-  if ((x >= WIDTH) ||              // Clip right
-      (y >= HEIGHT) ||             // Clip bottom
-      ((x + 5 * size - 1) < 0) ||  // Clip left
-      ((y + 8 * size - 1) < 0)     // Clip top
+  x += originX;
+  y += originY;
+
+  if ((x >= clipRight) ||          // Clip right
+      (y >= clipBottom) ||         // Clip bottom
+      ((x + 6 * size - 1) < clipLeft) || // Clip left
+      ((y + 8 * size - 1) < clipTop) // Clip top
      )
   {
     return;
   }
 
-  for (uint8_t i = 0; i < 6; i++ )
+  // pixels are drawn if their color isn't BLACK, or if it differs from the
+  // other one
+  bool draw_foreground = color || draw_background;
+  draw_background = bg || draw_background;
+  if (!draw_foreground && !draw_background)
+    return;
+
+  // the columns of the font, and the blank one after them
+  uint8_t lines[6];
+  for (uint8_t i = 0; i < 5; i++)
+    lines[i] = pgm_read_byte(bitmap + i);
+  lines[5] = 0;
+
+  // the visible part of the character
+  int16_t left = x < clipLeft ? clipLeft : x;
+  int16_t right = x + 6 * size;
+  if (right > clipRight) right = clipRight;
+  int16_t top = y < clipTop ? clipTop : y;
+  int16_t bottom = y + 8 * size;
+  if (bottom > clipBottom) bottom = clipBottom;
+  if (left >= right || top >= bottom)
+    return;
+
+  uint8_t firstPage = top / 8;
+  uint8_t lastPage = (bottom - 1) / 8;
+  prepareDraw(left, right - 1, firstPage, lastPage);
+
+  for (uint8_t page = firstPage; page <= lastPage; page++)
   {
-    line = pgm_read_byte(bitmap++);
-    if (i == 5) {
-      line = 0x0;
-    }
+    int16_t pageTop = page * 8;
+
+    // the rows of the page within the character and the clip rows
+    uint8_t cell = 0xFF;
+    if (top > pageTop) cell <<= top - pageTop;
+    if (bottom < pageTop + 8) cell &= 0xFF >> (pageTop + 8 - bottom);
 
-    for (uint8_t j = 0; j < 8; j++)
+    // the rows of the page covered by each row of the font, which expands
+    // the bits of a font column to the text size
+    uint8_t rowMask[8];
+    if (size > 1)
     {
-      uint8_t draw_color = (line & 0x1) ? color : bg;
+      for (uint8_t j = 0; j < 8; j++)
+      {
+        int16_t r0 = y + j * size - pageTop;
+        int16_t r1 = r0 + size;
+        if (r0 < 0) r0 = 0;
+        if (r1 > 8) r1 = 8;
+        rowMask[j] = r0 < r1 ? (0xFF << r0) & (0xFF >> (8 - r1)) & cell : 0;
+      }
+    }
 
-      if (draw_color || draw_background) {
-        for (uint8_t a = 0; a < size; a++ ) {
-          for (uint8_t b = 0; b < size; b++ ) {
-            drawPixel(x + (i * size) + a, y + (j * size) + b, draw_color);
-          }
+    uint8_t *pBuf = sBuffer + page * WIDTH;
+    int16_t shift = y - pageTop;
+
+    for (uint8_t i = 0; i < 6; i++)
+    {
+      uint8_t fg;
+      if (size == 1)
+      {
+        fg = (shift >= 0 ? lines[i] << shift : lines[i] >> -shift) & cell;
+      }
+      else
+      {
+        fg = 0;
+        uint8_t line = lines[i];
+        for (uint8_t j = 0; line; j++, line >>= 1)
+        {
+          if (line & 1)
+            fg |= rowMask[j];
         }
       }
-      line >>= 1;
+      uint8_t fgMask = draw_foreground ? fg : 0;
+      uint8_t bgMask = draw_background ? cell & ~fg : 0;
+
+      // the columns of the screen showing this column of the font
+      int16_t x0 = x + i * size;
+      int16_t x1 = x0 + size;
+      if (x0 < left) x0 = left;
+      if (x1 > right) x1 = right;
+      for (int16_t xi = x0; xi < x1; xi++)
+      {
+        pBuf[xi] = colorPixels(colorPixels(pBuf[xi], fgMask, color),
+                                  bgMask, bg);
+      }
     }
   }
 }
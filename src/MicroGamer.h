@@ -66,6 +66,11 @@
 // Pixels that would exceed the display limits will be ignored.
 #define PIXEL_SAFE_MODE
 
+// If defined, no buffer is allocated for the entire display, saving 768
+// bytes of RAM. The display can then only be drawn using a strip renderer,
+// see MicroGamerBase::setStripRenderer().
+//#define STRIP_RENDERING_ONLY
+
 // pixel colors
 #define BLACK   0  /**< Color value for an unlit pixel for draw functions. */
 #define WHITE   1  /**< Color value for a lit pixel for draw functions. */
@@ -84,15 +89,23 @@
 
 #define CLEAR_BUFFER true /**< Value to be passed to `display()` to clear the screen buffer. */
 
+/** \brief
+ * The number of clip rectangles and viewports which can be pushed at once.
+ *
+ * \see MicroGamerBase::pushClip() MicroGamerBase::pushViewport()
+ */
+#define CLIP_STACK_SIZE 8
+
 
 /** \brief
- * A rectangle object for collision functions.
+ * A rectangle object for collision and clipping functions.
  *
  * \details
  * The X and Y coordinates specify the top left corner of a rectangle with the
  * given width and height.
  *
  * \see MicroGamerBase::collide(Point, Rect) MicroGamerBase::collide(Rect, Rect)
+ * MicroGamerBase::pushClip()
  */
 struct Rect
 {
@@ -116,6 +129,17 @@ struct Point
   int16_t y; /**< The Y coordinate of the point */
 };
 
+// The area drawing is restricted to, from the left column and top row to
+// the column and row after the last ones, in display coordinates.
+// (Not officially part of the API)
+struct ClipRect
+{
+  int16_t left;
+  int16_t top;
+  int16_t right;
+  int16_t bottom;
+};
+
 //====================================
 //========== MicroGamerBase ==========
 //====================================
@@ -339,9 +363,10 @@ class MicroGamerBase : public MicroGamerCore
    * Clear the display buffer.
    *
    * \details
-   * The entire contents of the screen buffer are cleared to BLACK.
+   * The entire contents of the screen buffer are cleared to BLACK, or only
+   * the clip rectangle when one is set.
    *
-   * \see display(bool)
+   * \see display(bool) pushClip()
    */
   void clear();
 
@@ -352,13 +377,22 @@ class MicroGamerBase : public MicroGamerCore
    * The contents of the display buffer in RAM are copied to the display and
    * will appear on the screen. This is an asynchronous function, which means
    * that the function will return before the buffer is completely sent to the
-   * display. It is therefore recommended to wait until the transfer is complete
-   * before drawing on the frame buffer, otherwise graphic glitches may appear.
-   * You can use the function waitDisplayUpdate() to make sure the frame buffer
-   * transfer is complete before drawing a new frame, or enable double
-   * buffering.
+   * display.
+   *
+   * The drawing functions of this library can be used to draw the next frame
+   * while the transfer is in progress. The buffer is sent from the top page
+   * (8 pixel high row) to the bottom one, and a drawing function which
+   * modifies a page that hasn't been sent yet waits for it to be sent.
+   * Drawing from the top of the screen to the bottom therefore overlaps with
+   * the transfer, without the RAM cost of double buffering. A sketch that
+   * writes directly to the frame buffer must use `waitForPage()` or
+   * waitDisplayUpdate() first, otherwise graphic glitches may appear.
+   *
+   * If a strip renderer has been set, it is called to draw the frame, which
+   * is sent one page at a time instead of from the display buffer.
    *
-   * \see display(bool) waitDisplayUpdate() enableDoubleBuffer()
+   * \see display(bool) waitDisplayUpdate() waitForPage() enableDoubleBuffer()
+   * setStripRenderer()
    */
   void display();
 
@@ -398,17 +432,309 @@ class MicroGamerBase : public MicroGamerCore
    * provide higher frame rate, but it also takes an extra 1K of RAM to allocate
    * the extra buffer.
    *
-   * \see display()
+   * Double buffering isn't available if `STRIP_RENDERING_ONLY` is defined.
+   *
+   * \see display() setDisplayBuffers()
    */
   void enableDoubleBuffer();
 
   /** \brief
    * Returns the state of double buffering feature.
    *
-   * \return True if double buffer is enabled.
+   * \return True if double buffering, or a ring of more display buffers,
+   * is enabled.
    */
   bool doubleBuffer();
 
+  /** \brief
+   * Use a ring of display buffers, to draw frames ahead of the display.
+   *
+   * \param buffers An array of `count` additional display buffers of
+   * `WIDTH * HEIGHT / 8` bytes each, for example declared in the sketch as
+   * `uint8_t buffers[2][WIDTH * HEIGHT / 8];` and passed as `buffers[0]`.
+   * `NULL` to go back to a single display buffer.
+   * \param count The number of additional buffers in the array.
+   *
+   * \details
+   * The additional buffers and the library's own display buffer are used in
+   * turn. `display()` queues the finished frame to be sent to the display
+   * and returns as soon as the next buffer of the ring is free, which is
+   * when the frame previously drawn in it has been sent. The interrupt
+   * handler sends the queued frames one after the other, so with two or
+   * more additional buffers the sketch can draw ahead while the display is
+   * updated at the steady rate of the transfers.
+   *
+   * With one additional buffer this is the same as `enableDoubleBuffer()`,
+   * using a buffer provided by the sketch instead of one allocated with
+   * malloc(). The transfer queue holds up to 4 frames, so more than 3
+   * additional buffers are of no use.
+   *
+   * This function waits for the current transfers to be complete and starts
+   * the ring with the library's display buffer, which should be done before
+   * drawing a frame. Partial updates are not used with a ring of buffers.
+   * It has no effect if `STRIP_RENDERING_ONLY` is defined.
+   *
+   * \see display() enableDoubleBuffer() getBuffer() queuePaintScreen()
+   */
+  void setDisplayBuffers(uint8_t *buffers, uint8_t count);
+
+  /** \brief
+   * Set a function to draw the display one strip at a time.
+   *
+   * \param renderer A function that draws the entire display using the
+   * drawing functions of the library, or `NULL` to go back to drawing in the
+   * display buffer.
+   *
+   * \details
+   * Instead of drawing a frame in the display buffer and then sending the
+   * buffer to the display, a sketch can draw with a strip renderer function.
+   * `display()` then calls the function once for each 8 pixel high page of
+   * the display, passing the number of the page (0 to 7) as a parameter.
+   * During each call the drawing functions only modify a 128 byte strip
+   * holding the page, which is cleared to BLACK before the call and sent to
+   * the display after it. Two strips are used alternately, so the next page
+   * is drawn while the previous one is being sent.
+   *
+   * Everything is drawn and clipped to the current page, so the function
+   * can draw the whole frame on every call. Drawing can be skipped for
+   * objects that are not on the page, for a faster frame. The function must
+   * draw the same frame for all the pages; in particular the text cursor
+   * should be set before printing. `getPixel()` can only read the pixels of
+   * the current page.
+   *
+   * The strips use the memory of the display buffer, so its contents are lost
+   * when a frame is drawn with a strip renderer. If `STRIP_RENDERING_ONLY` is
+   * defined in MicroGamer.h, only the strips are allocated and the display
+   * can't be drawn without a strip renderer.
+   *
+   * \see display() paintScreenPage()
+   */
+  void setStripRenderer(void (*renderer)(uint8_t page));
+
+  /** \brief
+   * Enable or disable partial display updates.
+   *
+   * \param enable `true` to only send the modified parts of the display
+   * buffer to the display. `false` to send the entire buffer every frame.
+   *
+   * \details
+   * When partial updates are enabled, `display()` only transfers the columns
+   * of each 8 pixel high page of the display buffer that were modified since
+   * the previous transfer. A frame in which only a small object moved can be
+   * sent in a fraction of the time taken by a full transfer. The number of
+   * bytes sent for the last frame can be obtained with `paintScreenBytes()`.
+   *
+   * The drawing functions keep track of the areas they modify. Clearing the
+   * buffer modifies the entire screen, so to benefit from partial updates a
+   * sketch should erase only the objects that moved instead of clearing the
+   * whole buffer every frame.
+   *
+   * \note
+   * \parblock
+   * A sketch that writes directly to the buffer returned by `getBuffer()` must
+   * report the modified area using `markDirty()`.
+   *
+   * Partial updates are not used when double buffering is enabled, because
+   * the buffer being drawn doesn't hold the frame that is on the display.
+   * \endparblock
+   *
+   * \see display() markDirty() paintScreenBytes()
+   */
+  void setPartialUpdate(bool enable);
+
+  /** \brief
+   * Returns the state of the partial display updates feature.
+   *
+   * \return True if partial updates are enabled.
+   *
+   * \see setPartialUpdate()
+   */
+  bool partialUpdate();
+
+  /** \brief
+   * Scroll the display vertically, without sending the image again.
+   *
+   * \param y The row of the display buffer to show at the top of the
+   * display, 0 to 63.
+   *
+   * \details
+   * The display is set to start showing its RAM, which holds the display
+   * buffer, at the given row, wrapping around to the top of the buffer after
+   * its bottom row. A vertical scroller can then move its view by changing
+   * this setting, and only draw the rows coming into view, instead of
+   * redrawing and sending the entire buffer. With partial updates enabled,
+   * only the pages modified are then sent.
+   *
+   * \note
+   * The drawing functions don't apply this mapping: they always draw in
+   * display buffer coordinates, and converting screen coordinates is the
+   * sketch's job. The row of the display buffer shown at a screen Y
+   * coordinate is given by `bufferY()`, which is where something must be
+   * drawn to appear at that position on the screen. An object which crosses
+   * the bottom of the buffer must be drawn a second time, 64 pixels higher,
+   * for its part that wraps around to the top.
+   *
+   * The setting is kept when the display is turned off and on again with
+   * `displayOff()` and `displayOn()`.
+   *
+   * \see scrollY() bufferY() setPartialUpdate() MicroGamerCore::setStartLine()
+   */
+  static void setScrollY(uint8_t y);
+
+  /** \brief
+   * Get the row of the display buffer shown at the top of the display.
+   *
+   * \return The value set by `setScrollY()`, 0 by default.
+   *
+   * \see setScrollY()
+   */
+  static uint8_t scrollY();
+
+  /** \brief
+   * Get the display buffer row shown at a screen Y coordinate.
+   *
+   * \param y The Y coordinate on the screen.
+   *
+   * \return The row of the display buffer, 0 to 63, shown at the given Y
+   * coordinate, or at the same position on the 64 pixel high cycle of rows
+   * if it's outside of the screen.
+   *
+   * \details
+   * Use it to convert screen coordinates before passing them to the drawing
+   * functions, which work in display buffer coordinates.
+   *
+   * \see setScrollY()
+   */
+  static uint8_t bufferY(int16_t y);
+
+  /** \brief
+   * Mark an area of the display buffer as modified.
+   *
+   * \param x The X coordinate of the top left corner of the area.
+   * \param y The Y coordinate of the top left corner of the area.
+   * \param w The width of the area in pixels.
+   * \param h The height of the area in pixels.
+   *
+   * \details
+   * The area will be transferred by the next `display()` when partial updates
+   * are enabled. Parts of the area outside the display are ignored.
+   *
+   * \see setPartialUpdate() markAllDirty()
+   */
+  static void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  // Called before modifying the given columns and pages of the display
+  // buffer. Waits for the pages to be sent if the buffer is being
+  // transferred, then marks the columns as modified.
+  // The coordinates must be within the display.
+  // (Not officially part of the API)
+  static inline void prepareDraw(uint8_t x0, uint8_t x1,
+                                 uint8_t page0, uint8_t page1)
+  {
+    if (page1 >= paintPagesSent && sBuffer == paintImage) {
+      waitForPage(page1);
+    }
+    markDirtyColumns(x0, x1, page0, page1);
+  }
+
+  // Called before drawing in an area given in display coordinates: calls
+  // prepareDraw() for the part of the area within the clip rectangle.
+  // Returns false if none of it is, and there is nothing to draw.
+  // (Not officially part of the API)
+  static bool prepareDrawRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  // The rows of a page within the clip rectangle, as a mask of its bits.
+  // The page must be one of those the clip rectangle covers.
+  // (Not officially part of the API)
+  static inline uint8_t clipMask(uint8_t page)
+  {
+    uint8_t mask = 0xFF;
+    if (page == clipTop / 8)
+      mask <<= clipTop & 7;
+    if (page == (clipBottom - 1) / 8)
+      mask &= 0xFF >> (7 - ((clipBottom - 1) & 7));
+    return mask;
+  }
+
+  /** \brief
+   * Restrict drawing to a rectangle.
+   *
+   * \param clip The rectangle, in the coordinates of the current viewport.
+   *
+   * \return `true` if the rectangle was pushed, `false` if `CLIP_STACK_SIZE`
+   * rectangles and viewports have already been pushed, in which case
+   * nothing is changed and `popClip()` mustn't be called for it.
+   *
+   * \details
+   * Until the matching `popClip()`, the drawing functions of this class,
+   * `MicroGamer::drawChar()`, `Sprites`, `TileMap` and `AssetCache` leave
+   * the pixels outside of the rectangle unchanged. `fillScreen()`,
+   * `fillScreenPattern()`, `clear()` and `scroll()` only modify the pixels
+   * inside it.
+   *
+   * The rectangle is combined with the ones already pushed: drawing is
+   * restricted to the area common to all of them. Clipping happens once
+   * for each shape, bitmap or character drawn, so drawing to a part of the
+   * display costs no more than drawing to the whole display.
+   *
+   * \code
+   * // the status bar, clipped to the top 8 rows
+   * mg.pushClip(Rect{0, 0, WIDTH, 8});
+   * drawStatusBar();
+   * mg.popClip();
+   * \endcode
+   *
+   * \see pushViewport() popClip()
+   */
+  static bool pushClip(Rect clip);
+
+  /** \brief
+   * Restrict drawing to a rectangle and move the origin of the coordinates
+   * to its top left corner.
+   *
+   * \param viewport The rectangle, in the coordinates of the current
+   * viewport.
+   *
+   * \return `true` if the viewport was pushed, `false` if `CLIP_STACK_SIZE`
+   * rectangles and viewports have already been pushed, in which case
+   * nothing is changed and `popClip()` mustn't be called for it.
+   *
+   * \details
+   * As with `pushClip()`, drawing is restricted to the rectangle. In
+   * addition, until the matching `popClip()`, the coordinates given to
+   * drawing functions are relative to the top left corner of the
+   * viewport. A scene can then be drawn in any part of the display, for
+   * instance for each player of a split screen game:
+   *
+   * \code
+   * mg.pushViewport(Rect{0, 0, 64, 64});
+   * drawScene(player1);
+   * mg.popClip();
+   * mg.pushViewport(Rect{64, 0, 64, 64});
+   * drawScene(player2);
+   * mg.popClip();
+   * \endcode
+   *
+   * The functions which aren't given coordinates of the display, such as
+   * `markDirty()`, `getBuffer()` and the text cursor of `MicroGamer`, are
+   * unaffected, except for `getPixel()`. Text wraps at the right edge of
+   * the clip rectangle.
+   *
+   * \see pushClip() popClip()
+   */
+  static bool pushViewport(Rect viewport);
+
+  /** \brief
+   * Restore the clip rectangle and viewport in effect before the last
+   * `pushClip()` or `pushViewport()`.
+   *
+   * \details
+   * Nothing is done if nothing was pushed.
+   *
+   * \see pushClip() pushViewport()
+   */
+  static void popClip();
+
   /** \brief
    * Set a single pixel in the display buffer to the specified color.
    *
@@ -423,6 +749,20 @@ class MicroGamerBase : public MicroGamerCore
    */
   void drawPixel(int16_t x, int16_t y, uint8_t color = WHITE);
 
+  /** \brief
+   * Set a single pixel in the display buffer to a color given at compile
+   * time.
+   *
+   * \tparam color The color of the pixel: WHITE, BLACK or INVERT.
+   *
+   * \details
+   * This is `drawPixel(x, y, color)` without the test of the color at run
+   * time, for instance `drawPixel<BLACK>(x, y)`.
+   *
+   * \see drawPixel(int16_t, int16_t, uint8_t)
+   */
+  template <uint8_t color> void drawPixel(int16_t x, int16_t y);
+
   /** \brief
    * Returns the state of the given pixel in the screen buffer.
    *
@@ -430,6 +770,12 @@ class MicroGamerBase : public MicroGamerCore
    * \param y The Y coordinate of the pixel.
    *
    * \return WHITE if the pixel is on or BLACK if the pixel is off.
+   *
+   * \details
+   * The coordinates are relative to the current viewport. Pixels outside of
+   * the display are BLACK.
+   *
+   * \see pushViewport()
    */
   uint8_t getPixel(uint8_t x, uint8_t y);
 
@@ -440,6 +786,10 @@ class MicroGamerBase : public MicroGamerCore
    * \param y0 The Y coordinate of the circle's center.
    * \param r The radius of the circle in pixels.
    * \param color The circle's color (optional; defaults to WHITE).
+   *
+   * \details
+   * Each pixel of the outline is drawn once, so with INVERSE every pixel is
+   * inverted exactly once.
    */
   void drawCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
 
@@ -454,9 +804,43 @@ class MicroGamerBase : public MicroGamerCore
    * \param y0 The Y coordinate of the circle's center.
    * \param r The radius of the circle in pixels.
    * \param color The circle's color (optional; defaults to WHITE).
+   *
+   * \details
+   * Each pixel of the circle is drawn once, so with INVERSE every pixel is
+   * inverted exactly once.
    */
   void fillCircle(int16_t x0, int16_t y0, uint8_t r, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw an ellipse of given radii.
+   *
+   * \param x0 The X coordinate of the ellipse's center.
+   * \param y0 The Y coordinate of the ellipse's center.
+   * \param rx The horizontal radius of the ellipse in pixels.
+   * \param ry The vertical radius of the ellipse in pixels.
+   * \param color The ellipse's color (optional; defaults to WHITE).
+   *
+   * \details
+   * The outline drawn is made of the pixels of the ellipse filled by
+   * `fillEllipse()` which are on its edge.
+   *
+   * \see fillEllipse() drawCircle()
+   */
+  void drawEllipse(int16_t x0, int16_t y0, uint8_t rx, uint8_t ry, uint8_t color = WHITE);
+
+  /** \brief
+   * Draw a filled-in ellipse of given radii.
+   *
+   * \param x0 The X coordinate of the ellipse's center.
+   * \param y0 The Y coordinate of the ellipse's center.
+   * \param rx The horizontal radius of the ellipse in pixels.
+   * \param ry The vertical radius of the ellipse in pixels.
+   * \param color The ellipse's color (optional; defaults to WHITE).
+   *
+   * \see drawEllipse() fillCircle()
+   */
+  void fillEllipse(int16_t x0, int16_t y0, uint8_t rx, uint8_t ry, uint8_t color = WHITE);
+
   // Draw one or both vertical halves of a filled-in circle or
   // rounded rectangle edge.
   // (Not officially part of the API)
@@ -507,6 +891,19 @@ class MicroGamerBase : public MicroGamerCore
    */
   void drawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a horizontal line of a color given at compile time.
+   *
+   * \tparam color The color of the line: WHITE, BLACK or INVERT.
+   *
+   * \details
+   * This is `drawFastHLine(x, y, w, color)` without the test of the color
+   * at run time, for instance `drawFastHLine<WHITE>(x, y, w)`.
+   *
+   * \see drawFastHLine(int16_t, int16_t, uint8_t, uint8_t)
+   */
+  template <uint8_t color> void drawFastHLine(int16_t x, int16_t y, uint8_t w);
+
   /** \brief
    * Draw a filled-in rectangle of a specified width and height.
    *
@@ -521,10 +918,61 @@ class MicroGamerBase : public MicroGamerCore
   /** \brief
    * Fill the screen buffer with the specified color.
    *
-   * \param color The fill color (optional; defaults to WHITE).
+   * \param color The fill color (optional; defaults to WHITE). With
+   * INVERSE, all the pixels of the screen buffer are inverted.
+   *
+   * \details
+   * When a clip rectangle is set, only the pixels inside it are changed.
+   *
+   * \see clear() fillScreenPattern() pushClip()
    */
   void fillScreen(uint8_t color = WHITE);
 
+  /** \brief
+   * Fill the screen buffer with a repeating pattern.
+   *
+   * \param pattern An array of 8 bytes, each one representing a vertical
+   * column of 8 pixels with the least significant bit at the top, as for
+   * `drawBitmap()`. The array can be in program memory, using the PROGMEM
+   * modifier.
+   *
+   * \details
+   * The pattern is repeated every 8 pixels, horizontally and vertically,
+   * starting at the top left corner of the screen. This can be used to
+   * draw a dithered background, for example with the pattern
+   * `{0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA}` for a 50% gray.
+   *
+   * When a clip rectangle is set, only the pixels inside it are changed,
+   * the pattern still starting at the top left corner of the screen.
+   *
+   * \see fillScreen() pushClip()
+   */
+  void fillScreenPattern(const uint8_t *pattern);
+
+  /** \brief
+   * Shift the contents of the screen buffer.
+   *
+   * \param dx The number of pixels to move the contents right by, or left
+   * by if negative.
+   * \param dy The number of pixels to move the contents down by, or up by
+   * if negative.
+   * \param fill The color of the pixels uncovered at the edges (optional;
+   * defaults to BLACK).
+   *
+   * \details
+   * The image in the buffer is moved, and the pixels moved out of the screen
+   * are lost. A sketch scrolling its playfield can use this to only draw the
+   * part that comes into view, instead of redrawing everything.
+   *
+   * Only the pages within the rows being drawn are scrolled, so this has no
+   * effect on the rest of the display from a strip renderer. Likewise, when
+   * a clip rectangle is set, only the pixels inside it are moved, and those
+   * moved out of it are lost.
+   *
+   * \see fillScreen() pushClip()
+   */
+  static void scroll(int8_t dx, int8_t dy, uint8_t fill = BLACK);
+
   /** \brief
    * Draw a rectangle with rounded corners.
    *
@@ -572,9 +1020,38 @@ class MicroGamerBase : public MicroGamerCore
    * \details
    * A triangle is drawn by specifying each of the three corner locations.
    * The corners can be at any position with respect to the others.
+   *
+   * The pixels whose coordinates are inside the triangle are drawn. Those
+   * exactly on an edge are only drawn for top and left edges, so that
+   * triangles sharing an edge don't overlap: a pixel is never drawn twice,
+   * which matters with INVERT. The bottom and right edges of the outline
+   * drawn by `drawTriangle()` are therefore not filled, and a triangle with
+   * all its corners on a line draws nothing.
+   *
+   * \see fillPolygon() drawTriangle()
    */
   void fillTriangle (int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a filled-in convex polygon.
+   *
+   * \param corners An array of the corners of the polygon, in order around
+   * it, either clockwise or counterclockwise.
+   * \param count The number of corners, at least 3.
+   * \param color The polygon's color (optional; defaults to WHITE).
+   *
+   * \details
+   * The polygon must be convex: any straight line crosses its outline at
+   * most twice. Other shapes won't be filled correctly.
+   *
+   * The polygon is filled row by row, following its left and right sides
+   * from the top corner to the bottom one, with the same rules as
+   * `fillTriangle()` for the pixels on its edges.
+   *
+   * \see fillTriangle()
+   */
+  void fillPolygon(const Point *corners, uint8_t count, uint8_t color = WHITE);
+
   /** \brief
    * Draw a bitmap from an array in program memory.
    *
@@ -599,6 +1076,24 @@ class MicroGamerBase : public MicroGamerCore
    */
   static void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h, uint8_t color = WHITE);
 
+  /** \brief
+   * Draw a bitmap from an array in program memory, with a color given at
+   * compile time.
+   *
+   * \tparam color The color of pixels for bits set to 1 in the bitmap:
+   * WHITE, BLACK or INVERT.
+   *
+   * \details
+   * This is `drawBitmap(x, y, bitmap, w, h, color)` without the test of the
+   * color for each byte of the bitmap, for instance
+   * `drawBitmap<INVERT>(x, y, bitmap, w, h)`. The call with the color as an
+   * argument tests it once and calls this function.
+   *
+   * \see drawBitmap(int16_t, int16_t, const uint8_t*, uint8_t, uint8_t, uint8_t)
+   */
+  template <uint8_t color>
+  static void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t w, uint8_t h);
+
   /** \brief
    * Draw a bitmap from a horizontally oriented array in program memory.
    *
@@ -645,13 +1140,37 @@ class MicroGamerBase : public MicroGamerCore
    * https://github.com/TEAMarg/Cabi
    *
    * Bits set to 1 in the provided bitmap array will have their corresponding
-   * pixel set to the specified color. For bits set to 0 in the array, the
-   * corresponding pixel will be left unchanged.
+   * pixel set to the specified color, or inverted for INVERSE as with
+   * `drawBitmap()`. For bits set to 0 in the array, the corresponding pixel
+   * will be left unchanged.
    *
    * The array must be located in program memory by using the PROGMEM modifier.
+   *
+   * The data is decoded a run of pixels at a time, and runs of bits set to 0
+   * are skipped without being drawn, so compressed backgrounds can be drawn
+   * every frame. The function keeps no state between calls: it can be used
+   * by a strip renderer or called from an interrupt.
    */
   static void drawCompressed(int16_t sx, int16_t sy, const uint8_t *bitmap, uint8_t color = WHITE);
 
+  /** \brief
+   * Decompress a bitmap from an array of compressed data.
+   *
+   * \param dest A pointer to the array to put the bitmap in.
+   * \param bitmap A pointer to the compressed bitmap array in program memory,
+   * in the format used by `drawCompressed()`.
+   *
+   * \details
+   * The bitmap is decoded in the format used by `drawBitmap()`, so that it
+   * can be drawn with that function without decoding it again, for instance
+   * when the same image is drawn every frame. Each byte specifies a vertical
+   * column of 8 pixels, and the array must be large enough to hold
+   * `w * ((h + 7) / 8)` bytes for a bitmap of `w` by `h` pixels.
+   *
+   * \see drawCompressed() drawBitmap() AssetCache
+   */
+  static void decompress(uint8_t *dest, const uint8_t *bitmap);
+
   /** \brief
    * Get a pointer to the display buffer in RAM.
    *
@@ -1139,11 +1658,61 @@ class MicroGamerBase : public MicroGamerCore
    */
   static uint8_t *sBuffer;
 
+  // The area drawing functions are restricted to, in display coordinates:
+  // the first column and row to be drawn and the ones after the last ones.
+  // It's the intersection of clipRect and of the strip rows, or all zeros
+  // if they don't intersect.
+  // (Not officially part of the API)
+  static int16_t clipLeft;
+  static int16_t clipTop;
+  static int16_t clipRight;
+  static int16_t clipBottom;
+
+  // The position of the current viewport on the display, added to the
+  // coordinates given to the drawing functions.
+  // (Not officially part of the API)
+  static int16_t originX;
+  static int16_t originY;
+
+  // The clip rectangle set by pushClip() and pushViewport(), and the rows
+  // drawing is restricted to by a strip renderer or a display list, which
+  // are the whole display otherwise. updateClip() must be called after
+  // changing them.
+  // (Not officially part of the API)
+  static ClipRect clipRect;
+  static int16_t stripTop;
+  static int16_t stripBottom;
+
+  // Set clipLeft, clipTop, clipRight and clipBottom from clipRect and the
+  // strip rows.
+  // (Not officially part of the API)
+  static void updateClip();
+
  protected:
 
+  // Draw and send a frame using the strip renderer
+  void displayStrips();
+
+  // The clip rectangles and viewports saved by pushClip() and
+  // pushViewport()
+  struct ClipState
+  {
+    ClipRect rect;
+    int16_t originX;
+    int16_t originY;
+  };
+  static ClipState clipStack[CLIP_STACK_SIZE];
+  static uint8_t clipDepth;
+
   // Static allocation of a single frame buffer. When double buffering is
   // enabled, the second buffer is allocated dynamically with malloc().
-  static uint8_t staticAllocatedBuffer[(HEIGHT*WIDTH)/8];
+  // The strips of the strip renderer are also located in this buffer.
+  // Word aligned for the word stores of fillScreen().
+#ifdef STRIP_RENDERING_ONLY
+  static uint8_t staticAllocatedBuffer[WIDTH * 2] __attribute__ ((aligned (4)));
+#else
+  static uint8_t staticAllocatedBuffer[(HEIGHT*WIDTH)/8] __attribute__ ((aligned (4)));
+#endif
 
   // helper function for sound enable/disable system control
   void sysCtrlSound(uint8_t buttons, uint8_t led, uint8_t eeVal);
@@ -1165,7 +1734,18 @@ class MicroGamerBase : public MicroGamerCore
   bool justRendered;
   uint8_t lastFrameDurationMs;
 
-  static uint8_t *displayBuffer;
+  // Additional buffers of the display buffer ring, following the static
+  // buffer, and the position of sBuffer in the ring
+  static uint8_t *displayBuffers;
+  static uint8_t displayBufferCount;
+  static uint8_t displayBufferIndex;
+
+  static bool partialUpdates;
+
+  // display buffer row shown at the top of the display
+  static uint8_t scrollOffset;
+
+  static void (*stripRenderer)(uint8_t page);
 };
 
 
@@ -1440,7 +2020,8 @@ class MicroGamer : public Print, public MicroGamerBase
    * Text wrap mode is enabled by specifying `true`. In wrap mode, the text
    * cursor will be moved to the start of the next line (based on the current
    * text size) if the following character wouldn't fit entirely at the end of
-   * the current line.
+   * the current line. The end of the line is the right edge of the clip
+   * rectangle, if one is set with `pushClip()` or `pushViewport()`.
 
    * If wrap mode is disabled, characters will continue to be written to the
    * same line. A character at the right edge of the screen may only be
@@ -153,13 +153,88 @@ const uint8_t PROGMEM lcdBootProgram[] = {
   OLED_HORIZ_FLIPPED, OLED_VERTICAL_FLIPPED // Flip the screen
 };
 
+// Bytes on the bus for a full screen transfer: one command transaction
+// (address, control, window commands) then one data transaction
+// (address, control, pixels)
+#define PAINT_SCREEN_BYTES (2 + sizeof(lcdWindowProgram) + 2 + (WIDTH * HEIGHT / 8))
+
+// Bytes on the bus for a partial page transfer, not including the pixels:
+// address, six Co=1 command pairs and the data control byte
+#define PAINT_PAGE_OVERHEAD (1 + sizeof(twiPageHeader))
+
+// Column and page address window covering the entire display
+const uint8_t PROGMEM lcdWindowProgram[] = {
+  SSD1306_COLUMNADDR, 0, WIDTH - 1,
+  SSD1306_PAGEADDR, 0, (HEIGHT / 8) - 1
+};
+
+// Interrupt driven TWI transaction queue.
+//
+// Commands and pixel data are queued as transactions which are sent
+// back-to-back by the TWI interrupt handler. Each transaction is given a
+// ticket, which is the number of transactions queued up to and including it.
+// A transaction has completed when twiCompleted reaches its ticket.
+
+#define TWI_QUEUE_SIZE 8 // must be a power of 2
+
+// Kinds of transactions
+#define TWI_BYTES 0 // the inline bytes followed by the data bytes
+#define TWI_PAGES 1 // a partial screen transfer, one transaction per page
+#define TWI_FRAME 2 // as TWI_BYTES, for an entire screen of pixel data
+#define TWI_STRIP 3 // as TWI_BYTES, for the next page of pixel data
+
+struct TwiTransaction
+{
+  const uint8_t *data; // sent after the inline bytes (image for TWI_PAGES)
+  uint16_t length;     // number of data bytes
+  uint8_t kind;
+  uint8_t count;       // number of inline bytes, starting with the control byte
+  uint8_t bytes[7];
+};
+
+static TwiTransaction twiQueue[TWI_QUEUE_SIZE];
+static volatile uint16_t twiQueued = 0;
+static volatile uint16_t twiCompleted = 0;
+static uint16_t twiFrameTicket = 0; // ticket of the last screen transfer
+
 volatile bool twiInProgress = false;
-const uint8_t *twiTxData = NULL;
-size_t twiByteToSend = 0;
+static const uint8_t *twiTxData = NULL;
+static size_t twiByteToSend = 0;
+static bool twiSendingHeader; // inline bytes being sent, data bytes follow
+static const uint8_t *twiFrameData; // start of the screen data being sent
+
+// State of a partial screen transfer, used by the interrupt handler to send
+// one transaction per modified page
+static uint8_t twiPage; // next page to be sent
+static uint8_t twiPageStart[HEIGHT/8];
+static uint8_t twiPageEnd[HEIGHT/8];
+static uint8_t twiPageHeader[] = {
+  0x80, SSD1306_COLUMNADDR, // Co = 1, D/C = 0
+  0x80, 0,                  // column start address
+  0x80, 0,                  // column end address
+  0x80, SSD1306_PAGEADDR,
+  0x80, 0,                  // page start address
+  0x80, 0,                  // page end address
+  0x40                      // Co = 0, D/C = 1
+};
+
+static uint16_t paintBytes = 0;
+
+// Number of entire screen transfers queued and completed
+static uint8_t paintFramesQueued = 0;
+static volatile uint8_t paintFramesDone = 0;
+
+const uint8_t *MicroGamerCore::paintImage = NULL;
+volatile uint8_t MicroGamerCore::paintPagesSent = HEIGHT/8;
+
+uint8_t MicroGamerCore::dirtyStart[];
+uint8_t MicroGamerCore::dirtyEnd[];
+uint8_t MicroGamerCore::startLine = 0;
 
 MicroGamerCore::MicroGamerCore()
 {
   twiInProgress = false;
+  markAllDirty();
 }
 
 void MicroGamerCore::boot()
@@ -201,9 +276,7 @@ void MicroGamerCore::bootOLED()
 
   // run our customized boot-up command sequence against the
   // OLED to initialize it properly for MicroGamer
-  for (uint8_t i = 0; i < sizeof(lcdBootProgram); i++) {
-    sendLCDCommand(pgm_read_byte(lcdBootProgram + i));
-  }
+  sendLCDCommands(lcdBootProgram, sizeof(lcdBootProgram));
 }
 
 void MicroGamerCore::bootTWI()
@@ -275,29 +348,9 @@ uint8_t MicroGamerCore::twiTransmit(const uint8_t data[],
   return 0;
 }
 
-void MicroGamerCore::twiTransmitAsync(const uint8_t data[],
-                                       size_t quantity)
-{
-
-  if (quantity == 0) {
-    return;
-  }
-
-  if (quantity > 1 ) {
-    twiInProgress = true;
-    twiTxData = data + 1;
-    twiByteToSend = quantity - 1;
-
-    NVIC_ClearPendingIRQ(TWI_IRQn);
-    NVIC_EnableIRQ(TWI_IRQn);
-  }
-
-  TWI_DEVICE->TXD = data[0];
-}
-
 uint8_t MicroGamerCore::twiTransmit(uint8_t data)
 {
-    twiTransmit(&data, 1);
+    return twiTransmit(&data, 1);
 }
 
 uint8_t MicroGamerCore::twiEndTransmission()
@@ -331,6 +384,159 @@ uint8_t MicroGamerCore::twiEndTransmission()
   return 0;
 }
 
+// Start sending the given header bytes in a new transaction. The interrupt
+// handler will follow them with the data of the current transaction.
+static void twiStartHeader(const uint8_t *header, uint8_t count)
+{
+  twiSendingHeader = true;
+  twiTxData = header + 1;
+  twiByteToSend = count - 1;
+
+  TWI_DEVICE->ADDRESS = SSD1306_I2C_ADDRESS;
+  TWI_DEVICE->SHORTS = 0x0UL;
+  TWI_DEVICE->TASKS_RESUME = 0x1UL;
+  TWI_DEVICE->TASKS_STARTTX = 0x1UL;
+  TWI_DEVICE->TXD = header[0];
+}
+
+// Start the transaction for the next modified page of a partial screen
+// transfer. Returns false if there are no more pages to send.
+static bool twiStartNextPage()
+{
+  while (twiPage < HEIGHT/8)
+  {
+    uint8_t page = twiPage++;
+
+    if (twiPageStart[page] > twiPageEnd[page])
+    {
+      continue;
+    }
+
+    // the pages before this one have been sent, or didn't need to be
+    MicroGamerCore::paintPagesSent = page;
+
+    twiPageHeader[3] = twiPageStart[page];
+    twiPageHeader[5] = twiPageEnd[page];
+    twiPageHeader[9] = page;
+    twiPageHeader[11] = page;
+
+    twiStartHeader(twiPageHeader, sizeof(twiPageHeader));
+    return true;
+  }
+
+  return false;
+}
+
+// Start the transaction at the head of the queue. Returns false if it has
+// nothing to send.
+static bool twiStartTransaction()
+{
+  TwiTransaction *t = &twiQueue[twiCompleted & (TWI_QUEUE_SIZE - 1)];
+
+  if (t->kind == TWI_PAGES)
+  {
+    twiPage = 0;
+    return twiStartNextPage();
+  }
+
+  if (t->kind == TWI_FRAME)
+  {
+    // another frame may have been queued after this one
+    MicroGamerCore::paintImage = t->data;
+    MicroGamerCore::paintPagesSent = 0;
+  }
+
+  twiStartHeader(t->bytes, t->count);
+  return true;
+}
+
+// Complete the transaction at the head of the queue
+static void twiCompleteTransaction()
+{
+  TwiTransaction *t = &twiQueue[twiCompleted & (TWI_QUEUE_SIZE - 1)];
+
+  if (t->kind == TWI_STRIP)
+  {
+    MicroGamerCore::paintPagesSent++;
+  }
+  else if (t->kind != TWI_BYTES)
+  {
+    MicroGamerCore::paintPagesSent = HEIGHT/8;
+    if (t->kind == TWI_FRAME)
+    {
+      paintFramesDone++;
+    }
+  }
+  twiFrameData = NULL;
+  twiCompleted++;
+}
+
+// Start the transactions from the head of the queue, until one has something
+// to send or the queue is empty.
+static void twiRunQueue()
+{
+  while (twiCompleted != twiQueued)
+  {
+    if (twiStartTransaction())
+    {
+      return;
+    }
+    twiCompleteTransaction();
+  }
+
+  twiInProgress = false;
+  NVIC_DisableIRQ(TWI_IRQn);
+}
+
+// Add a transaction to the queue, waiting for a free entry if it is full,
+// and start sending it if the queue was idle. Returns the ticket of the
+// transaction.
+static uint16_t twiQueueTransaction(uint8_t kind,
+                                    const uint8_t *bytes, uint8_t count,
+                                    const uint8_t *data, uint16_t length)
+{
+  while ((uint16_t)(twiQueued - twiCompleted) >= TWI_QUEUE_SIZE)
+  {
+    MicroGamerCore::idle();
+  }
+
+  TwiTransaction *t = &twiQueue[twiQueued & (TWI_QUEUE_SIZE - 1)];
+  t->kind = kind;
+  t->count = count;
+  // bytes can be NULL when there are none
+  if (count)
+    memcpy(t->bytes, bytes, count);
+  t->data = data;
+  t->length = length;
+
+  noInterrupts();
+  twiQueued++;
+  if (!twiInProgress)
+  {
+    twiInProgress = true;
+    NVIC_ClearPendingIRQ(TWI_IRQn);
+    NVIC_EnableIRQ(TWI_IRQn);
+    twiRunQueue();
+  }
+  interrupts();
+
+  return twiQueued;
+}
+
+// Returns true if the transaction with the given ticket has completed
+static inline bool twiTransactionDone(uint16_t ticket)
+{
+  return (int16_t)(twiCompleted - ticket) >= 0;
+}
+
+static void twiWaitTransaction(uint16_t ticket)
+{
+  while (!twiTransactionDone(ticket))
+  {
+    MicroGamerCore::idle();
+  }
+}
+
 extern "C" {
 
 void SPI1_TWI1_IRQHandler(void)
@@ -339,6 +545,33 @@ void SPI1_TWI1_IRQHandler(void)
   if(TWI_DEVICE->EVENTS_TXDSENT)
   {
     TWI_DEVICE->EVENTS_TXDSENT = 0;
+    if(twiByteToSend == 0 && twiSendingHeader)
+    {
+      // header sent, continue with the data of the transaction
+      TwiTransaction *t = &twiQueue[twiCompleted & (TWI_QUEUE_SIZE - 1)];
+      twiSendingHeader = false;
+      if (t->kind == TWI_PAGES)
+      {
+        uint8_t page = twiPage - 1;
+        twiTxData = t->data + (page * WIDTH) + twiPageStart[page];
+        twiByteToSend = twiPageEnd[page] - twiPageStart[page] + 1;
+      }
+      else
+      {
+        twiTxData = t->data;
+        twiByteToSend = t->length;
+        if (t->kind == TWI_FRAME)
+        {
+          twiFrameData = t->data;
+        }
+      }
+    }
+    else if (twiFrameData != NULL)
+    {
+      // publish the number of entire pages sent so far
+      MicroGamerCore::paintPagesSent = (twiTxData - twiFrameData) / WIDTH;
+    }
+
     if(twiByteToSend != 0)
     {
       TWI_DEVICE->TXD = *twiTxData++;
@@ -353,8 +586,12 @@ void SPI1_TWI1_IRQHandler(void)
   if(TWI_DEVICE->EVENTS_STOPPED)
   {
     TWI_DEVICE->EVENTS_STOPPED = 0;
-    twiInProgress = false;
-    NVIC_DisableIRQ(TWI_IRQn);
+    TwiTransaction *t = &twiQueue[twiCompleted & (TWI_QUEUE_SIZE - 1)];
+    if (t->kind != TWI_PAGES || !twiStartNextPage())
+    {
+      twiCompleteTransaction();
+      twiRunQueue();
+    }
   }
 
   if(TWI_DEVICE->EVENTS_RXDREADY)
@@ -364,9 +601,13 @@ void SPI1_TWI1_IRQHandler(void)
 
   if(TWI_DEVICE->EVENTS_ERROR)
   {
+    // abandon the transaction, the queue moves on once stopped
     TWI_DEVICE->EVENTS_ERROR = 0;
-    twiInProgress = false;
-    NVIC_DisableIRQ(TWI_IRQn);
+    TWI_DEVICE->ERRORSRC = TWI_DEVICE->ERRORSRC;
+    twiPage = HEIGHT/8;
+    twiByteToSend = 0;
+    twiSendingHeader = false;
+    TWI_DEVICE->TASKS_STOP = 1;
   }
 }
 
@@ -378,6 +619,9 @@ void MicroGamerCore::idle()
 {
   // set_sleep_mode(SLEEP_MODE_IDLE);
   // sleep_mode();
+
+  // lets the time pass on host builds, does nothing on the target
+  yield();
 }
 
 void MicroGamerCore::bootPowerSaving()
@@ -402,6 +646,11 @@ void MicroGamerCore::displayOff()
 void MicroGamerCore::displayOn()
 {
   bootOLED();
+  // the boot program resets the start line
+  if (startLine != 0) {
+    setStartLine(startLine);
+  }
+  markAllDirty();
 }
 
 uint8_t MicroGamerCore::width() { return WIDTH; }
@@ -414,63 +663,210 @@ uint8_t MicroGamerCore::height() { return HEIGHT; }
 void MicroGamerCore::paintScreen(const uint8_t *image)
 {
   waitEndOfPaintScreen();
+  queuePaintScreen(image);
+}
 
-  sendLCDCommand(SSD1306_COLUMNADDR);
-  sendLCDCommand(0);   // Column start address (0 = reset)
-  sendLCDCommand(WIDTH-1); // Column end address (127 = reset)
+void MicroGamerCore::queuePaintScreen(const uint8_t *image)
+{
+  const uint8_t dataControl = 0x40; // Co = 0, D/C = 1
 
-  sendLCDCommand(SSD1306_PAGEADDR);
-  sendLCDCommand(0); // Page start address (0 = reset)
-  sendLCDCommand(7); // Page end address
+  sendLCDCommands(lcdWindowProgram, sizeof(lcdWindowProgram));
 
-  twiBeginTransmission(SSD1306_I2C_ADDRESS);
-  twiTransmit(0x40);
-  twiTransmitAsync(image, SSD1306_LCDWIDTH*SSD1306_LCDHEIGHT/8);
+  noInterrupts();
+  if (twiTransactionDone(twiFrameTicket)) {
+    // sent next, the drawing functions must follow its transfer
+    paintImage = image;
+    paintPagesSent = 0;
+  }
+  interrupts();
+  paintFramesQueued++;
+  twiFrameTicket = twiQueueTransaction(TWI_FRAME, &dataControl, 1,
+                                       image, WIDTH * HEIGHT / 8);
+
+  paintBytes = PAINT_SCREEN_BYTES;
+  memset(dirtyStart, 0xFF, sizeof(dirtyStart));
+  memset(dirtyEnd, 0, sizeof(dirtyEnd));
+}
+
+void MicroGamerCore::paintScreenDirty(const uint8_t *image)
+{
+  uint16_t bytes = 0;
+
+  waitEndOfPaintScreen();
+
+  for (uint8_t page = 0; page < HEIGHT/8; page++) {
+    if (dirtyStart[page] <= dirtyEnd[page]) {
+      bytes += PAINT_PAGE_OVERHEAD + dirtyEnd[page] - dirtyStart[page] + 1;
+    }
+  }
+
+  if (bytes >= PAINT_SCREEN_BYTES) {
+    paintScreen(image);
+    return;
+  }
+
+  memcpy(twiPageStart, dirtyStart, sizeof(twiPageStart));
+  memcpy(twiPageEnd, dirtyEnd, sizeof(twiPageEnd));
+  memset(dirtyStart, 0xFF, sizeof(dirtyStart));
+  memset(dirtyEnd, 0, sizeof(dirtyEnd));
+
+  paintBytes = bytes;
+  if (bytes == 0) {
+    return;
+  }
+
+  paintImage = image;
+  paintPagesSent = 0;
+  twiFrameTicket = twiQueueTransaction(TWI_PAGES, NULL, 0, image, 0);
+}
+
+void MicroGamerCore::paintScreenPage(const uint8_t *page, uint8_t pageNumber)
+{
+  const uint8_t dataControl = 0x40; // Co = 0, D/C = 1
+
+  if (pageNumber == 0) {
+    waitEndOfPaintScreen();
+
+    // the pages follow each other in the window, which wraps to the top
+    sendLCDCommands(lcdWindowProgram, sizeof(lcdWindowProgram));
+
+    paintImage = NULL;
+    paintPagesSent = 0;
+    paintBytes = 2 + sizeof(lcdWindowProgram);
+  }
+
+  twiFrameTicket = twiQueueTransaction(TWI_STRIP, &dataControl, 1,
+                                       page, WIDTH);
+  paintBytes += 2 + WIDTH;
+
+  if (pageNumber == (HEIGHT/8) - 1) {
+    memset(dirtyStart, 0xFF, sizeof(dirtyStart));
+    memset(dirtyEnd, 0, sizeof(dirtyEnd));
+  }
+}
+
+uint8_t MicroGamerCore::paintScreensPending()
+{
+  return paintFramesQueued - paintFramesDone;
+}
+
+uint16_t MicroGamerCore::paintScreenBytes()
+{
+  return paintBytes;
+}
+
+void MicroGamerCore::markAllDirty()
+{
+  memset(dirtyStart, 0, sizeof(dirtyStart));
+  memset(dirtyEnd, WIDTH - 1, sizeof(dirtyEnd));
 }
 
 bool MicroGamerCore::paintScreenInProgress()
 {
-    return twiInProgress;
+    return !twiTransactionDone(twiFrameTicket);
 }
 
 void MicroGamerCore::waitEndOfPaintScreen()
 {
-  while (twiInProgress) {
+  twiWaitTransaction(twiFrameTicket);
+}
+
+uint8_t MicroGamerCore::paintScreenPagesSent()
+{
+  return paintPagesSent;
+}
+
+void MicroGamerCore::waitForPage(uint8_t page)
+{
+  while (paintPagesSent <= page) {
     idle();
   }
 }
 
+void MicroGamerCore::waitEndOfLCDCommands()
+{
+  twiWaitTransaction(twiQueued);
+}
+
+void MicroGamerCore::sendLCDCommands(const uint8_t *commands, size_t count)
+{
+  uint8_t bytes[7] = {0x00}; // Co = 0, D/C = 0
+
+  if (count < sizeof(bytes)) {
+    // short lists are copied into the queue, no need to wait
+    memcpy(bytes + 1, commands, count);
+    twiQueueTransaction(TWI_BYTES, bytes, count + 1, NULL, 0);
+  } else {
+    twiWaitTransaction(twiQueueTransaction(TWI_BYTES, bytes, 1,
+                                           commands, count));
+  }
+}
+
 void MicroGamerCore::sendLCDCommand(uint8_t command)
 {
-  uint8_t data[2] = {0x00,  // Co = 0, D/C = 0
-                     command};
-  twiBeginTransmission(SSD1306_I2C_ADDRESS);
-  twiTransmit(data, 2);
-  twiEndTransmission();
+  sendLCDCommands(&command, 1);
 }
 
 void MicroGamerCore::sendLCDCommand(uint8_t command,
                                   uint8_t command2)
 {
-  uint8_t data[3] = {0x00,  // Co = 0, D/C = 0
-                     command,
+  uint8_t data[2] = {command,
                      command2};
-  twiBeginTransmission(SSD1306_I2C_ADDRESS);
-  twiTransmit(data, 3);
-  twiEndTransmission();
+  sendLCDCommands(data, 2);
 }
 
 void MicroGamerCore::sendLCDCommand(uint8_t command,
                                   uint8_t command2,
                                   uint8_t command3)
 {
-  uint8_t data[4] = {0x00,  // Co = 0, D/C = 0
-                     command,
+  uint8_t data[3] = {command,
                      command2,
                      command3};
-  twiBeginTransmission(SSD1306_I2C_ADDRESS);
-  twiTransmit(data, 4);
-  twiEndTransmission();
+  sendLCDCommands(data, 3);
+}
+
+void MicroGamerCore::setContrast(uint8_t contrast)
+{
+  sendLCDCommand(SSD1306_SETCONTRAST, contrast);
+}
+
+void MicroGamerCore::setStartLine(uint8_t line)
+{
+  startLine = line & 0x3F;
+  sendLCDCommand(SSD1306_SETSTARTLINE | startLine);
+}
+
+void MicroGamerCore::startHorizontalScroll(bool left, uint16_t frames,
+                                           uint8_t startPage, uint8_t endPage)
+{
+  // frames between steps for each value of the time interval setting
+  static const uint16_t intervalFrames[8] = {5, 64, 128, 256, 3, 4, 25, 2};
+  uint8_t interval = 0;
+
+  for (uint8_t i = 1; i < 8; i++) {
+    if (abs((int16_t)intervalFrames[i] - (int16_t)frames) <
+        abs((int16_t)intervalFrames[interval] - (int16_t)frames)) {
+      interval = i;
+    }
+  }
+
+  uint8_t commands[] = {
+    // the scroll must be stopped before it is set up
+    SSD1306_DEACTIVATE_SCROLL,
+    (uint8_t)(left ? SSD1306_LEFT_HORIZONTAL_SCROLL :
+               SSD1306_RIGHT_HORIZONTAL_SCROLL),
+    0x00, (uint8_t)(startPage & 7), interval, (uint8_t)(endPage & 7),
+    0x00, 0xFF,
+    SSD1306_ACTIVATE_SCROLL
+  };
+  sendLCDCommands(commands, sizeof(commands));
+}
+
+void MicroGamerCore::stopHorizontalScroll()
+{
+  sendLCDCommand(SSD1306_DEACTIVATE_SCROLL);
+  // the display RAM no longer matches the display buffer
+  markAllDirty();
 }
 
 // invert the display or set to normal
@@ -178,6 +178,101 @@ class MicroGamerCore
      */
     void static paintScreen(const uint8_t *image);
 
+    /** \brief
+     * Queue an entire image to be painted after the current screen transfers.
+     *
+     * \param image A byte array representing the entire contents of the
+     * display, in the same format as for `paintScreen()`.
+     *
+     * \details
+     * This function is the same as `paintScreen()` except that it doesn't
+     * wait for the end of the previous screen transfer. The image is sent
+     * by the interrupt handler as soon as the transfers queued before it are
+     * complete, so several frames can be waiting to be sent, each in its own
+     * buffer. The array of an image must not be modified until it has been
+     * sent, which can be checked with `paintScreensPending()`.
+     *
+     * If the transfer queue is full, this function waits for a free entry.
+     *
+     * \see paintScreen() paintScreensPending() MicroGamerBase::setDisplayBuffers()
+     */
+    void static queuePaintScreen(const uint8_t *image);
+
+    /** \brief
+     * Get the number of entire images waiting to be sent or being sent.
+     *
+     * \return The number of images queued by `paintScreen()` and
+     * `queuePaintScreen()` which haven't been completely sent.
+     *
+     * \details
+     * The images are sent in the order they were queued, so when this
+     * function returns `n`, all the images except the `n` most recently
+     * queued ones have been sent.
+     *
+     * \see queuePaintScreen()
+     */
+    uint8_t static paintScreensPending();
+
+    /** \brief
+     * Asynchronously paints only the modified parts of an image to the
+     * display.
+     *
+     * \param image A byte array representing the entire contents of the
+     * display, in the same format as for `paintScreen()`.
+     *
+     * \details
+     * Only the columns of each page (8 pixel high row) that have been marked
+     * as modified, using `markDirty()` or the drawing functions, since the
+     * last transfer are written to the display. Each modified page is sent
+     * as a separate transaction, preceded by the SSD1306 column and page
+     * address commands which restrict the write to the modified columns.
+     *
+     * If sending the modified regions would take as many bytes as painting
+     * the entire image, the entire image is painted instead.
+     *
+     * As for `paintScreen()`, this is an asynchronous function.
+     *
+     * \see paintScreen() paintScreenBytes() markDirty()
+     */
+    void static paintScreenDirty(const uint8_t *image);
+
+    /** \brief
+     * Asynchronously paints one page (8 pixel high row) of the display.
+     *
+     * \param page A byte array of `WIDTH` bytes representing the contents
+     * of the page, in the same format as a row of the image for
+     * `paintScreen()`.
+     * \param pageNumber The page to paint, from 0 for the top of the display
+     * to `(HEIGHT / 8) - 1` for the bottom.
+     *
+     * \details
+     * This function allows a frame to be painted one page at a time, without
+     * a buffer for the entire screen. The pages must be painted in order,
+     * starting with page 0 which waits for the end of the previous screen
+     * transfer. The array of a page must not be modified until the page has
+     * been sent, which can be checked with `paintScreenPagesSent()`.
+     *
+     * As for `paintScreen()`, this is an asynchronous function.
+     *
+     * \see paintScreen() waitForPage() MicroGamerBase::setStripRenderer()
+     */
+    void static paintScreenPage(const uint8_t *page, uint8_t pageNumber);
+
+    /** \brief
+     * Get the number of bytes sent by the last screen transfer.
+     *
+     * \return The number of bytes, including the I2C address, control and
+     * addressing command bytes, sent to the display by the last call to
+     * `paintScreen()` or `paintScreenDirty()`.
+     *
+     * \details
+     * At 400 kHz each byte takes about 22.5 microseconds, so this value can be
+     * used to estimate the time spent transferring a frame.
+     *
+     * \see paintScreen() paintScreenDirty()
+     */
+    uint16_t static paintScreenBytes();
+
     /** \brief
      * Paint screen in progress.
      *
@@ -194,6 +289,56 @@ class MicroGamerCore
      */
     void static waitEndOfPaintScreen();
 
+    /** \brief
+     * Get the progress of the current screen transfer.
+     *
+     * \return The number of pages (8 pixel high rows), starting from the top
+     * of the display, that have been completely sent by the current screen
+     * transfer. If no transfer is in progress, `HEIGHT / 8` is returned.
+     *
+     * \details
+     * The pages of an image are sent from top to bottom, so once a page has
+     * been sent it can be modified for the next frame while the following
+     * pages are still being transferred. This allows the next frame to be
+     * drawn "behind the beam" of the transfer, rather than waiting for the
+     * entire image to be sent.
+     *
+     * \see waitForPage() paintScreen() paintScreenDirty()
+     */
+    uint8_t static paintScreenPagesSent();
+
+    /** \brief
+     * Wait until a page of the current screen transfer has been sent.
+     *
+     * \param page The page (8 pixel high row) to wait for.
+     *
+     * \details
+     * When this function returns, the given page and all the pages above it
+     * have been sent to the display and can be modified without the
+     * modification showing up in the current frame. It returns immediately
+     * if no transfer is in progress.
+     *
+     * The drawing functions of the `MicroGamerBase` class call this function
+     * when they write to the screen buffer being sent, so it only has to be
+     * used by a sketch that writes directly to the screen buffer.
+     *
+     * \see paintScreenPagesSent() waitEndOfPaintScreen()
+     */
+    void static waitForPage(uint8_t page);
+
+    /** \brief
+     * Wait until all queued display commands have been sent.
+     *
+     * \details
+     * Commands sent with `sendLCDCommand()`, `sendLCDCommands()` and
+     * the functions that use them, such as `invert()`, are queued and sent
+     * in the background. This function can be used when a command must have
+     * taken effect before continuing, for example before powering down.
+     *
+     * \see sendLCDCommands()
+     */
+    void static waitEndOfLCDCommands();
+
     /** \brief
      * Invert the entire display or set it back to normal.
      *
@@ -268,6 +413,73 @@ class MicroGamerCore
      */
     void static flipHorizontal(bool flipped);
 
+    /** \brief
+     * Set the display contrast.
+     *
+     * \param contrast The contrast level, from 0 (dimmest) to 255
+     * (brightest). The default set when the display is booted is 207.
+     */
+    void static setContrast(uint8_t contrast);
+
+    /** \brief
+     * Set the display RAM row shown at the top of the display.
+     *
+     * \param line The row of the display RAM, 0 to 63, shown on the top
+     * row of the display.
+     *
+     * \details
+     * The display shows its RAM starting with the given row, wrapping around
+     * to row 0 after row 63, which scrolls the display vertically without
+     * sending the image again. The command is queued after any screen
+     * transfer in progress, so it takes effect once the frame has been sent.
+     *
+     * The setting is kept when the display is turned off and on again with
+     * `displayOff()` and `displayOn()`.
+     *
+     * `MicroGamerBase::setScrollY()` also keeps the offset for
+     * `MicroGamerBase::bufferY()`.
+     *
+     * \see MicroGamerBase::setScrollY() startHorizontalScroll()
+     */
+    void static setStartLine(uint8_t line);
+
+    /** \brief
+     * Start the continuous horizontal scrolling of the display.
+     *
+     * \param left `true` to scroll the image to the left, `false` to scroll
+     * it to the right.
+     * \param frames The number of display frames between each one pixel
+     * step. The display supports 2, 3, 4, 5, 25, 64, 128 and 256 frames, and
+     * the nearest of these is used.
+     * \param startPage,endPage The first and last pages (8 pixel high rows)
+     * to scroll, from 0 to 7 (optional; defaults to the whole display).
+     *
+     * \details
+     * The display moves the columns of the given pages around in its RAM by
+     * itself, the column moved out on one side coming back on the other,
+     * until `stopHorizontalScroll()` is called. This can animate a scrolling
+     * background with no processing and no data sent to the display.
+     *
+     * The display RAM must not be written while it scrolls, so `display()`
+     * must not be called until the scrolling is stopped.
+     *
+     * \see stopHorizontalScroll() setStartLine()
+     */
+    void static startHorizontalScroll(bool left, uint16_t frames,
+                                      uint8_t startPage = 0,
+                                      uint8_t endPage = HEIGHT / 8 - 1);
+
+    /** \brief
+     * Stop the continuous horizontal scrolling of the display.
+     *
+     * \details
+     * As the display RAM has been modified by the scrolling, the whole
+     * display buffer is sent by the next partial update.
+     *
+     * \see startHorizontalScroll()
+     */
+    void static stopHorizontalScroll();
+
     /** \brief
      * Send a single command byte to the display.
      *
@@ -276,11 +488,17 @@ class MicroGamerCore
      * \details
      * The display will be set to command mode then the specified command
      * byte will be sent. The display will then be set to data mode.
-     * Multi-byte commands can be sent by calling this function multiple times.
+     * The command is queued and sent in the background by the TWI interrupt,
+     * after any previously queued commands and screen transfers, so this
+     * function returns immediately.
+     * Multi-byte commands can be sent by calling this function multiple times,
+     * or more efficiently by using `sendLCDCommands()`.
      *
      * \note
      * Sending improper commands to the display can place it into invalid or
      * unexpected states, possibly even causing physical damage.
+     *
+     * \see sendLCDCommands()
      */
     void static sendLCDCommand(uint8_t command);
 
@@ -291,6 +509,73 @@ class MicroGamerCore
                                uint8_t command2,
                                uint8_t command3);
 
+    /** \brief
+     * Send a list of command bytes to the display in a single transfer.
+     *
+     * \param commands An array of command bytes.
+     * \param count The number of bytes in the array.
+     *
+     * \details
+     * The display will be set to command mode once, then all the command bytes
+     * will be streamed in the same I2C transaction. This avoids the start,
+     * address and stop overhead of sending each byte with `sendLCDCommand()`.
+     * Any mix of single and multi-byte commands can be sent.
+     *
+     * Lists of up to 6 bytes are copied into the transfer queue and the
+     * function returns immediately. Longer lists are sent directly from the
+     * given array, so the function waits until they have been sent.
+     *
+     * \note
+     * Sending improper commands to the display can place it into invalid or
+     * unexpected states, possibly even causing physical damage.
+     *
+     * \see sendLCDCommand()
+     */
+    void static sendLCDCommands(const uint8_t *commands, size_t count);
+
+    /** \brief
+     * Mark a region of the screen buffer as modified.
+     *
+     * \param x0,x1 The first and last modified columns.
+     * \param page0,page1 The first and last modified pages (8 pixel high
+     * rows).
+     *
+     * \details
+     * The region will be sent to the display by the next call to
+     * `paintScreenDirty()`. The coordinates must be within the display.
+     *
+     * The drawing functions mark the regions they modify, so this only has
+     * to be used by a sketch that writes directly to the screen buffer.
+     *
+     * \see markAllDirty() paintScreenDirty() MicroGamerBase::markDirty()
+     */
+    static inline void markDirtyColumns(uint8_t x0, uint8_t x1,
+                                        uint8_t page0, uint8_t page1)
+    {
+      for (uint8_t page = page0; page <= page1; page++) {
+        if (x0 < dirtyStart[page]) {
+          dirtyStart[page] = x0;
+        }
+        if (x1 > dirtyEnd[page]) {
+          dirtyEnd[page] = x1;
+        }
+      }
+    }
+
+    /** \brief
+     * Mark the entire screen buffer as modified.
+     *
+     * \see markDirtyColumns() paintScreenDirty()
+     */
+    void static markAllDirty();
+
+    // The image being sent by the current screen transfer and the number of
+    // its pages which have been sent (HEIGHT / 8 when idle). Used by the
+    // drawing functions to wait for the pages they modify.
+    // (Not officially part of the API)
+    static const uint8_t *paintImage;
+    static volatile uint8_t paintPagesSent;
+
     /** \brief
      * Initialize the MicroGamer's hardware.
      *
@@ -328,14 +613,22 @@ class MicroGamerCore
     void static bootPowerSaving();
     void static bootTWI();
 
+    // Blocking transfers, which must not be used while commands or screen
+    // transfers are queued
     void static twiBeginTransmission(uint8_t address);
     uint8_t static twiTransmit(const uint8_t data[],
                                size_t quantity);
 
-    void static twiTransmitAsync(const uint8_t data[],
-                                    size_t quantity);
     uint8_t static twiTransmit(uint8_t data);
     uint8_t static twiEndTransmission();
+
+    // First and last modified column of each page since the last transfer.
+    // A page is unmodified when its start is greater than its end.
+    static uint8_t dirtyStart[HEIGHT/8];
+    static uint8_t dirtyEnd[HEIGHT/8];
+
+    // The display RAM row shown at the top, restored by displayOn()
+    static uint8_t startLine;
 };
 
 #endif
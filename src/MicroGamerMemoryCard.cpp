@@ -4,9 +4,16 @@
 
 #define FLASH_PAGE_SIZE (1024)
 
+#ifndef MICROGAMER_HOST
 uint32_t flash_data[FLASH_PAGE_SIZE]
   __attribute__((aligned(FLASH_PAGE_SIZE), section (".rodata")))
     = { 0 };
+#else
+// read only data can't be written by the host's flash controller model
+uint32_t flash_data[FLASH_PAGE_SIZE]
+  __attribute__((aligned(FLASH_PAGE_SIZE)))
+    = { 0 };
+#endif
 
 static void memcpy_by_word(uint32_t *dest, const uint32_t *src, size_t n)
 {
@@ -39,7 +46,7 @@ void MicroGamerMemoryCard::save()
     NRF_NVMC->CONFIG = NVMC_CONFIG_WEN_Een << NVMC_CONFIG_WEN_Pos;
 
     // Erase the page in flash
-    NRF_NVMC->ERASEPCR1 = (uint32_t)flash_data;
+    NRF_NVMC->ERASEPCR1 = (uint32_t)(uintptr_t)flash_data;
 
     // Wait for the end of the erase operation
     while (NRF_NVMC->READY == 0) {
@@ -32,6 +32,100 @@ void Sprites::drawPlusMask(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t
   draw(x, y, bitmap, frame, NULL, 0, SPRITE_PLUS_MASK);
 }
 
+void Sprites::drawPreshifted(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPreshiftedFrame(x, y, sprite, frame, SPRITE_MASKED);
+}
+
+void Sprites::drawPreshiftedSelfMasked(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPreshiftedFrame(x, y, sprite, frame, SPRITE_IS_MASK);
+}
+
+void Sprites::drawPreshiftedErase(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame)
+{
+  drawPreshiftedFrame(x, y, sprite, frame, SPRITE_IS_MASK_ERASE);
+}
+
+// A byte of the image (plane 0) or mask (plane 1) to pre-shift
+static uint8_t preshiftSource(const uint8_t *bitmap, const uint8_t *mask,
+                              uint8_t plane, uint16_t i)
+{
+  if (plane == 0) {
+    return pgm_read_byte(bitmap + i);
+  }
+  return mask != NULL ? pgm_read_byte(mask + i) : 0xFF;
+}
+
+void Sprites::preshift(uint8_t *preshifted, const uint8_t *bitmap,
+                       const uint8_t *mask, uint8_t frames)
+{
+  uint8_t width = pgm_read_byte(bitmap);
+  uint8_t height = pgm_read_byte(++bitmap);
+  bitmap++;
+  uint8_t pages = height / 8 + (height % 8 == 0 ? 0 : 1);
+  uint16_t frame_offset = width * pages;
+
+  *preshifted++ = width;
+  *preshifted++ = height;
+
+  for (uint8_t frame = 0; frame < frames; frame++) {
+    for (uint8_t shift = 0; shift < 8; shift++) {
+      // the image, then the mask, each one row taller than the original
+      for (uint8_t plane = 0; plane < 2; plane++) {
+        for (uint8_t row = 0; row <= pages; row++) {
+          for (uint8_t col = 0; col < width; col++) {
+            // the row above in the low byte, the row itself in the high one
+            uint16_t column = 0;
+            if (row > 0) {
+              column = preshiftSource(bitmap, mask, plane, (row - 1) * width + col);
+            }
+            if (row < pages) {
+              column |= preshiftSource(bitmap, mask, plane, row * width + col) << 8;
+            }
+            *preshifted++ = (column << shift) >> 8;
+          }
+        }
+      }
+    }
+    bitmap += frame_offset;
+    if (mask != NULL) {
+      mask += frame_offset;
+    }
+  }
+}
+
+void Sprites::drawPreshiftedFrame(int16_t x, int16_t y,
+                                  const uint8_t *sprite, uint8_t frame,
+                                  uint8_t draw_mode)
+{
+  if (sprite == NULL)
+    return;
+
+  uint8_t width = pgm_read_byte(sprite);
+  uint8_t height = pgm_read_byte(++sprite);
+  sprite++;
+  uint8_t pages = height / 8 + (height % 8 == 0 ? 0 : 1);
+  uint16_t plane_size = width * (pages + 1);
+  // the shift of the sprite on the display, which is also the number of
+  // pixels between the top of the page and the sprite for negative
+  // coordinates
+  int16_t displayY = y + MicroGamerBase::originY;
+  uint8_t yOffset = displayY & 7;
+
+  // the same test as for the original sprite, as the pre-shifted one is
+  // taller
+  if (displayY + pages * 8 <= MicroGamerBase::clipTop ||
+      displayY >= MicroGamerBase::clipBottom)
+    return;
+
+  const uint8_t *image = sprite + (frame * 8 + yOffset) * plane_size * 2;
+
+  // the extra row of the planes is empty when there's no shift
+  drawBitmap(x, y - yOffset, image, image + plane_size, width,
+             (pages + (yOffset != 0 ? 1 : 0)) * 8, draw_mode);
+}
+
 
 //common functions
 void Sprites::draw(int16_t x, int16_t y,
@@ -67,55 +161,243 @@ void Sprites::draw(int16_t x, int16_t y,
   drawBitmap(x, y, bitmap, mask, width, height, drawMode);
 }
 
+// Draw the rows of a page aligned sprite, all of which are inside the
+// clipped pages, with a plain copy, OR, AND-NOT or masked loop.
+static void drawAligned(uint8_t *buffer_ofs, const uint8_t *bofs,
+                        const uint8_t *mask_ofs, uint8_t rendered_width,
+                        uint8_t loop_h, uint16_t sprite_jump,
+                        uint8_t draw_mode)
+{
+  uint8_t buffer_jump = WIDTH - rendered_width;
+
+  for (uint8_t a = 0; a < loop_h; a++) {
+    uint8_t *row_end = buffer_ofs + rendered_width;
+
+    switch (draw_mode) {
+      case SPRITE_UNMASKED:
+        while (buffer_ofs < row_end) {
+          *buffer_ofs++ = pgm_read_byte(bofs++);
+        }
+        break;
+
+      case SPRITE_IS_MASK:
+        while (buffer_ofs < row_end) {
+          *buffer_ofs++ |= pgm_read_byte(bofs++);
+        }
+        break;
+
+      case SPRITE_IS_MASK_ERASE:
+        while (buffer_ofs < row_end) {
+          *buffer_ofs++ &= ~pgm_read_byte(bofs++);
+        }
+        break;
+
+      case SPRITE_MASKED:
+        while (buffer_ofs < row_end) {
+          *buffer_ofs = (*buffer_ofs & ~pgm_read_byte(mask_ofs++)) |
+                        pgm_read_byte(bofs++);
+          buffer_ofs++;
+        }
+        break;
+
+      case SPRITE_PLUS_MASK:
+        while (buffer_ofs < row_end) {
+          *buffer_ofs = (*buffer_ofs & ~pgm_read_byte(bofs + 1)) |
+                        pgm_read_byte(bofs);
+          buffer_ofs++;
+          bofs += 2;
+        }
+        break;
+    }
+    bofs += sprite_jump;
+    mask_ofs += sprite_jump;
+    buffer_ofs += buffer_jump;
+  }
+}
+
+// Shift a column of a sprite into a word straddling two pages. Every mode
+// then comes down to keeping the buffer bits set in `keep` and setting
+// those in `set`.
+static inline __attribute__((always_inline))
+void shiftColumn(const uint8_t *bofs, const uint8_t *mask_ofs,
+                 uint8_t yOffset, uint8_t draw_mode,
+                 uint32_t &keep, uint32_t &set)
+{
+  uint32_t bitmap_word = (uint32_t)pgm_read_byte(bofs) << yOffset;
+
+  switch (draw_mode) {
+    case SPRITE_UNMASKED:
+      keep = ~((uint32_t)0xFF << yOffset);
+      set = bitmap_word;
+      break;
+
+    case SPRITE_IS_MASK:
+      keep = 0xFFFFFFFF;
+      set = bitmap_word;
+      break;
+
+    case SPRITE_IS_MASK_ERASE:
+      keep = ~bitmap_word;
+      set = 0;
+      break;
+
+    default: // SPRITE_MASKED, SPRITE_PLUS_MASK
+      keep = ~((uint32_t)pgm_read_byte(mask_ofs) << yOffset);
+      set = bitmap_word;
+      break;
+  }
+}
+
+// Draw the rows of a sprite when the clip rectangle doesn't start or end on
+// a page boundary, masking the rows of each page outside of it. This is the
+// same as drawShifted(), without the loops specialised for each mode and
+// page.
+static void drawClipped(uint8_t *buffer_ofs, const uint8_t *bofs,
+                        const uint8_t *mask_ofs, uint8_t rendered_width,
+                        uint8_t loop_h, uint16_t sprite_jump,
+                        uint8_t yOffset, int8_t sRow,
+                        int8_t firstPage, int8_t lastPage, uint8_t draw_mode)
+{
+  uint8_t step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+  uint8_t buffer_jump = WIDTH - rendered_width;
+  uint32_t keep, set;
+
+  for (uint8_t a = 0; a < loop_h; a++) {
+    uint8_t *row_end = buffer_ofs + rendered_width;
+    uint8_t clip = sRow >= firstPage ? MicroGamerBase::clipMask(sRow) : 0;
+    uint8_t nextClip = yOffset != 0 && sRow < lastPage ?
+                       MicroGamerBase::clipMask(sRow + 1) : 0;
+
+    while (buffer_ofs < row_end) {
+      shiftColumn(bofs, mask_ofs, yOffset, draw_mode, keep, set);
+      if (clip) {
+        buffer_ofs[0] = (buffer_ofs[0] & (keep | ~clip)) | (set & clip);
+      }
+      if (nextClip) {
+        buffer_ofs[WIDTH] = (buffer_ofs[WIDTH] & ((keep >> 8) | ~nextClip)) |
+                            ((set >> 8) & nextClip);
+      }
+      buffer_ofs++;
+      bofs += step;
+      mask_ofs += step;
+    }
+    sRow++;
+    bofs += sprite_jump;
+    mask_ofs += sprite_jump;
+    buffer_ofs += buffer_jump;
+  }
+}
+
+// Draw the rows of a sprite which isn't page aligned. Only the first and
+// last rows can have a page outside the clipped pages, the others use a
+// loop writing both pages without any tests.
+// Always inlined, so that it's specialised for the constant mode it's
+// called with.
+static inline __attribute__((always_inline))
+void drawShifted(uint8_t *buffer_ofs, const uint8_t *bofs,
+                 const uint8_t *mask_ofs, uint8_t rendered_width,
+                 uint8_t loop_h, uint16_t sprite_jump,
+                 uint8_t yOffset, int8_t sRow,
+                 int8_t firstPage, int8_t lastPage, uint8_t draw_mode)
+{
+  uint8_t step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+  uint8_t buffer_jump = WIDTH - rendered_width;
+  uint32_t keep, set;
+
+  for (uint8_t a = 0; a < loop_h; a++) {
+    uint8_t *row_end = buffer_ofs + rendered_width;
+
+    if (sRow >= firstPage && sRow < lastPage) {
+      while (buffer_ofs < row_end) {
+        shiftColumn(bofs, mask_ofs, yOffset, draw_mode, keep, set);
+        buffer_ofs[0] = (buffer_ofs[0] & keep) | set;
+        buffer_ofs[WIDTH] = (buffer_ofs[WIDTH] & (keep >> 8)) | (set >> 8);
+        buffer_ofs++;
+        bofs += step;
+        mask_ofs += step;
+      }
+    } else if (sRow >= firstPage) {
+      while (buffer_ofs < row_end) {
+        shiftColumn(bofs, mask_ofs, yOffset, draw_mode, keep, set);
+        buffer_ofs[0] = (buffer_ofs[0] & keep) | set;
+        buffer_ofs++;
+        bofs += step;
+        mask_ofs += step;
+      }
+    } else {
+      while (buffer_ofs < row_end) {
+        shiftColumn(bofs, mask_ofs, yOffset, draw_mode, keep, set);
+        buffer_ofs[WIDTH] = (buffer_ofs[WIDTH] & (keep >> 8)) | (set >> 8);
+        buffer_ofs++;
+        bofs += step;
+        mask_ofs += step;
+      }
+    }
+    sRow++;
+    bofs += sprite_jump;
+    mask_ofs += sprite_jump;
+    buffer_ofs += buffer_jump;
+  }
+}
+
 void Sprites::drawBitmap(int16_t x, int16_t y,
                          const uint8_t *bitmap, const uint8_t *mask,
                          uint8_t w, uint8_t h, uint8_t draw_mode)
 {
-  // no need to draw at all of we're offscreen
-  if (x + w <= 0 || x > WIDTH - 1 || y + h <= 0 || y > HEIGHT - 1)
+  if (bitmap == NULL)
     return;
 
-  if (bitmap == NULL)
+  x += MicroGamerBase::originX;
+  y += MicroGamerBase::originY;
+
+  // no need to draw at all of we're outside the clip rectangle, whole
+  // bytes of the sprite being drawn
+  if (!MicroGamerBase::prepareDrawRect(x, y, w, (h + 7) & ~7))
     return;
 
   // xOffset technically doesn't need to be 16 bit but the math operations
   // are measurably faster if it is
-  uint16_t xOffset, ofs;
+  uint16_t xOffset;
+  // signed, as it starts one page above the display when the sprite is
+  // partly above it (only the page below is then written)
+  int16_t ofs;
   int8_t yOffset = abs(y) % 8;
   int8_t sRow = y / 8;
   uint8_t loop_h, start_h, rendered_width;
+  int8_t firstPage = MicroGamerBase::clipTop / 8;
+  int8_t lastPage = (MicroGamerBase::clipBottom - 1) / 8;
 
   if (y < 0 && yOffset > 0) {
     sRow--;
     yOffset = 8 - yOffset;
   }
 
-  // if the left side of the render is offscreen skip those loops
-  if (x < 0) {
-    xOffset = abs(x);
+  // if the left side of the render is clipped skip those loops
+  if (x < MicroGamerBase::clipLeft) {
+    xOffset = MicroGamerBase::clipLeft - x;
   } else {
     xOffset = 0;
   }
 
-  // if the right side of the render is offscreen skip those loops
-  if (x + w > WIDTH - 1) {
-    rendered_width = ((WIDTH - x) - xOffset);
+  // if the right side of the render is clipped skip those loops
+  if (x + w > MicroGamerBase::clipRight) {
+    rendered_width = ((MicroGamerBase::clipRight - x) - xOffset);
   } else {
     rendered_width = (w - xOffset);
   }
 
   // if the top side of the render is offscreen skip those loops
-  if (sRow < -1) {
-    start_h = abs(sRow) - 1;
+  if (sRow < firstPage - 1) {
+    start_h = firstPage - 1 - sRow;
   } else {
     start_h = 0;
   }
 
   loop_h = h / 8 + (h % 8 > 0 ? 1 : 0); // divide, then round up
 
-  // if (sRow + loop_h - 1 > (HEIGHT/8)-1)
-  if (sRow + loop_h > (HEIGHT / 8)) {
-    loop_h = (HEIGHT / 8) - sRow;
+  // if (sRow + loop_h - 1 > lastPage)
+  if (sRow + loop_h > lastPage + 1) {
+    loop_h = lastPage + 1 - sRow;
   }
 
   // prepare variables for loops later so we can compare with 0
@@ -124,233 +406,68 @@ void Sprites::drawBitmap(int16_t x, int16_t y,
 
   sRow += start_h;
   ofs = (sRow * WIDTH) + x + xOffset;
-  uint8_t *bofs = (uint8_t *)bitmap + (start_h * w) + xOffset;
-  uint8_t data;
 
-  uint8_t mul_amt = 1 << yOffset;
-  uint16_t mask_data;
-  uint16_t bitmap_data;
+  // sprite plus mask data has an image and a mask byte for each column
+  uint8_t step = draw_mode == SPRITE_PLUS_MASK ? 2 : 1;
+  const uint8_t *bofs = bitmap + ((start_h * w) + xOffset) * step;
+  // a sprite plus mask, or one without a mask, has its mask bytes (or
+  // unused ones) following the image bytes
+  const uint8_t *mask_ofs = mask != NULL ?
+                            mask + (start_h * w) + xOffset : bofs + 1;
+  uint16_t sprite_jump = (w - rendered_width) * step;
+
+  if (((MicroGamerBase::clipTop | MicroGamerBase::clipBottom) & 7) != 0) {
+    drawClipped(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                rendered_width, loop_h, sprite_jump, yOffset,
+                sRow, firstPage, lastPage, draw_mode);
+    return;
+  }
 
+  if (yOffset == 0) {
+    // page aligned: each sprite row covers exactly one page, so the row
+    // starting one page above the first one drawn is simply skipped
+    if (sRow < firstPage) {
+      sRow++;
+      loop_h--;
+      bofs += w * step;
+      mask_ofs += w * step;
+      ofs += WIDTH;
+    }
+    drawAligned(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                rendered_width, loop_h, sprite_jump, draw_mode);
+    return;
+  }
+
+  // the mode is a constant in each call, giving a loop specialised for it
   switch (draw_mode) {
     case SPRITE_UNMASKED:
-      // we only want to mask the 8 bits of our own sprite, so we can
-      // calculate the mask before the start of the loop
-      mask_data = ~(0xFF * mul_amt);
-      // really if yOffset = 0 you have a faster case here that could be
-      // optimized
-      for (uint8_t a = 0; a < loop_h; a++) {
-        for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
-          bitmap_data = pgm_read_byte(bofs) * mul_amt;
-
-          if (sRow >= 0) {
-            data = MicroGamerBase::sBuffer[ofs];
-            data &= (uint8_t)(mask_data);
-            data |= (uint8_t)(bitmap_data);
-            MicroGamerBase::sBuffer[ofs] = data;
-          }
-          if (yOffset != 0 && sRow < 7) {
-            data = MicroGamerBase::sBuffer[ofs + WIDTH];
-            data &= (*((unsigned char *) (&mask_data) + 1));
-            data |= (*((unsigned char *) (&bitmap_data) + 1));
-            MicroGamerBase::sBuffer[ofs + WIDTH] = data;
-          }
-          ofs++;
-          bofs++;
-        }
-        sRow++;
-        bofs += w - rendered_width;
-        ofs += WIDTH - rendered_width;
-      }
+      drawShifted(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                  rendered_width, loop_h, sprite_jump, yOffset,
+                  sRow, firstPage, lastPage, SPRITE_UNMASKED);
       break;
 
     case SPRITE_IS_MASK:
-      for (uint8_t a = 0; a < loop_h; a++) {
-        for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
-          bitmap_data = pgm_read_byte(bofs) * mul_amt;
-          if (sRow >= 0) {
-            MicroGamerBase::sBuffer[ofs] |= (uint8_t)(bitmap_data);
-          }
-          if (yOffset != 0 && sRow < 7) {
-            MicroGamerBase::sBuffer[ofs + WIDTH] |= (*((unsigned char *) (&bitmap_data) + 1));
-          }
-          ofs++;
-          bofs++;
-        }
-        sRow++;
-        bofs += w - rendered_width;
-        ofs += WIDTH - rendered_width;
-      }
+      drawShifted(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                  rendered_width, loop_h, sprite_jump, yOffset,
+                  sRow, firstPage, lastPage, SPRITE_IS_MASK);
       break;
 
     case SPRITE_IS_MASK_ERASE:
-      for (uint8_t a = 0; a < loop_h; a++) {
-        for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
-          bitmap_data = pgm_read_byte(bofs) * mul_amt;
-          if (sRow >= 0) {
-            MicroGamerBase::sBuffer[ofs]  &= ~(uint8_t)(bitmap_data);
-          }
-          if (yOffset != 0 && sRow < 7) {
-            MicroGamerBase::sBuffer[ofs + WIDTH] &= ~(*((unsigned char *) (&bitmap_data) + 1));
-          }
-          ofs++;
-          bofs++;
-        }
-        sRow++;
-        bofs += w - rendered_width;
-        ofs += WIDTH - rendered_width;
-      }
+      drawShifted(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                  rendered_width, loop_h, sprite_jump, yOffset,
+                  sRow, firstPage, lastPage, SPRITE_IS_MASK_ERASE);
       break;
 
     case SPRITE_MASKED:
-      uint8_t *mask_ofs;
-      mask_ofs = (uint8_t *)mask + (start_h * w) + xOffset;
-      for (uint8_t a = 0; a < loop_h; a++) {
-        for (uint8_t iCol = 0; iCol < rendered_width; iCol++) {
-          // NOTE: you might think in the yOffset==0 case that this results
-          // in more effort, but in all my testing the compiler was forcing
-          // 16-bit math to happen here anyways, so this isn't actually
-          // compiling to more code than it otherwise would. If the offset
-          // is 0 the high part of the word will just never be used.
-
-          // load data and bit shift
-          // mask needs to be bit flipped
-          mask_data = ~(pgm_read_byte(mask_ofs) * mul_amt);
-          bitmap_data = pgm_read_byte(bofs) * mul_amt;
-
-          if (sRow >= 0) {
-            data = MicroGamerBase::sBuffer[ofs];
-            data &= (uint8_t)(mask_data);
-            data |= (uint8_t)(bitmap_data);
-            MicroGamerBase::sBuffer[ofs] = data;
-          }
-          if (yOffset != 0 && sRow < 7) {
-            data = MicroGamerBase::sBuffer[ofs + WIDTH];
-            data &= (*((unsigned char *) (&mask_data) + 1));
-            data |= (*((unsigned char *) (&bitmap_data) + 1));
-            MicroGamerBase::sBuffer[ofs + WIDTH] = data;
-          }
-          ofs++;
-          mask_ofs++;
-          bofs++;
-        }
-        sRow++;
-        bofs += w - rendered_width;
-        mask_ofs += w - rendered_width;
-        ofs += WIDTH - rendered_width;
-      }
+      drawShifted(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                  rendered_width, loop_h, sprite_jump, yOffset,
+                  sRow, firstPage, lastPage, SPRITE_MASKED);
       break;
 
-
     case SPRITE_PLUS_MASK:
-      // *2 because we use double the bits (mask + bitmap)
-      bofs = (uint8_t *)(bitmap + ((start_h * w) + xOffset) * 2);
-
-      uint8_t xi = rendered_width; // used for x loop below
-      uint8_t yi = loop_h; // used for y loop below
-
-      // asm volatile(
-      //   "push r28\n" // save Y
-      //   "push r29\n"
-      //   "movw r28, %[buffer_page2_ofs]\n" // Y = buffer page 2 offset
-      //   "loop_y:\n"
-      //   "loop_x:\n"
-      //   // load bitmap and mask data
-      //   "lpm %A[bitmap_data], Z+\n"
-      //   "lpm %A[mask_data], Z+\n"
-
-      //   // shift mask and buffer data
-      //   "tst %[yOffset]\n"
-      //   "breq skip_shifting\n"
-      //   "mul %A[bitmap_data], %[mul_amt]\n"
-      //   "movw %[bitmap_data], r0\n"
-      //   "mul %A[mask_data], %[mul_amt]\n"
-      //   "movw %[mask_data], r0\n"
-
-
-      //   // SECOND PAGE
-      //   // if yOffset != 0 && sRow < 7
-      //   "cpi %[sRow], 7\n"
-      //   "brge end_second_page\n"
-      //   // then
-      //   "ld %[data], Y\n"
-      //   "com %B[mask_data]\n" // invert high byte of mask
-      //   "and %[data], %B[mask_data]\n"
-      //   "or %[data], %B[bitmap_data]\n"
-      //   // update buffer, increment
-      //   "st Y+, %[data]\n"
-
-      //   "end_second_page:\n"
-      //   "skip_shifting:\n"
-
-
-      //   // FIRST PAGE
-      //   // if sRow >= 0
-      //   "tst %[sRow]\n"
-      //   "brmi skip_first_page\n"
-      //   "ld %[data], %a[buffer_ofs]\n"
-      //   // then
-      //   "com %A[mask_data]\n"
-      //   "and %[data], %A[mask_data]\n"
-      //   "or %[data], %A[bitmap_data]\n"
-      //   // update buffer, increment
-      //   "st %a[buffer_ofs]+, %[data]\n"
-      //   "jmp end_first_page\n"
-
-      //   "skip_first_page:\n"
-      //   // since no ST Z+ when skipped we need to do this manually
-      //   "adiw %[buffer_ofs], 1\n"
-
-      //   "end_first_page:\n"
-
-      //   // "x_loop_next:\n"
-      //   "dec %[xi]\n"
-      //   "brne loop_x\n"
-
-      //   // increment y
-      //   "next_loop_y:\n"
-      //   "dec %[yi]\n"
-      //   "breq finished\n"
-      //   "mov %[xi], %[x_count]\n" // reset x counter
-      //   // sRow++;
-      //   "inc %[sRow]\n"
-      //   "clr __zero_reg__\n"
-      //   // sprite_ofs += (w - rendered_width) * 2;
-      //   "add %A[sprite_ofs], %A[sprite_ofs_jump]\n"
-      //   "adc %B[sprite_ofs], __zero_reg__\n"
-      //   // buffer_ofs += WIDTH - rendered_width;
-      //   "add %A[buffer_ofs], %A[buffer_ofs_jump]\n"
-      //   "adc %B[buffer_ofs], __zero_reg__\n"
-      //   // buffer_ofs_page_2 += WIDTH - rendered_width;
-      //   "add r28, %A[buffer_ofs_jump]\n"
-      //   "adc r29, __zero_reg__\n"
-
-      //   "rjmp loop_y\n"
-      //   "finished:\n"
-      //   // put the Y register back in place
-      //   "pop r29\n"
-      //   "pop r28\n"
-      //   "clr __zero_reg__\n" // just in case
-      //   : [xi] "+&r" (xi),
-      //   [yi] "+&r" (yi),
-      //   [sRow] "+&d" (sRow), // CPI requires an upper register
-      //   [data] "=&r" (data),
-      //   [mask_data] "=&r" (mask_data),
-      //   [bitmap_data] "=&r" (bitmap_data)
-      //   :
-      //   [x_count] "r" (rendered_width),
-      //   [y_count] "r" (loop_h),
-      //   [sprite_ofs] "z" (bofs),
-      //   [buffer_ofs] "x" (MicroGamerBase::sBuffer+ofs),
-      //   [buffer_page2_ofs] "r" (MicroGamerBase::sBuffer+ofs+WIDTH), // Y pointer
-      //   [buffer_ofs_jump] "r" (WIDTH-rendered_width),
-      //   [sprite_ofs_jump] "r" ((w-rendered_width)*2),
-      //   [yOffset] "r" (yOffset),
-      //   [mul_amt] "r" (mul_amt)
-      //   // declaring an extra high register clobber here for some reason
-      //   // prevents a compile error for some sketches:
-      //   // can't find a register in class 'LD_REGS' while reloading 'asm'
-      //   : "r24"
-      // );
+      drawShifted(MicroGamerBase::sBuffer + ofs, bofs, mask_ofs,
+                  rendered_width, loop_h, sprite_jump, yOffset,
+                  sRow, firstPage, lastPage, SPRITE_PLUS_MASK);
       break;
   }
 }
@@ -17,6 +17,17 @@
 #define SPRITE_IS_MASK_ERASE 251
 #define SPRITE_AUTO_MODE 255
 
+/** \brief
+ * The size, in bytes, of a pre-shifted sprite array.
+ *
+ * \param w,h The width and height of the sprite, in pixels.
+ * \param frames The number of frames.
+ *
+ * \see Sprites::preshift()
+ */
+#define PRESHIFTED_SPRITE_SIZE(w, h, frames) \
+  (2 + (frames) * 8 * 2 * (w) * ((h) / 8 + ((h) % 8 != 0) + 1))
+
 /** \brief
  * A class for drawing animated sprites from image and mask bitmaps.
  *
@@ -218,6 +229,90 @@ class Sprites
      */
     static void drawSelfMasked(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t frame);
 
+    /** \brief
+     * Convert a sprite to the pre-shifted format.
+     *
+     * \param preshifted A pointer to the array to write the pre-shifted
+     * sprite to. Its size must be given by `PRESHIFTED_SPRITE_SIZE()`.
+     * \param bitmap A pointer to the array containing the image frames.
+     * \param mask A pointer to the array containing the mask frames, or
+     * `NULL` for a mask covering the whole sprite.
+     * \param frames The number of frames to convert.
+     *
+     * \details
+     * Drawing a sprite at a Y coordinate which isn't a multiple of 8 means
+     * shifting each byte of the image and mask, and combining it with two
+     * pages of the buffer. A pre-shifted sprite stores, for each frame, the
+     * image and mask already shifted by each of the 8 possible amounts, so
+     * that `drawPreshifted()` and related functions only need to combine
+     * each byte with a single one of the buffer, as if the sprite were page
+     * aligned. This uses about 16 times as much memory as the original
+     * image (more for short sprites), in exchange for faster drawing.
+     *
+     * The array begins with the width and height, followed by the data for
+     * each frame. For each of the vertical offsets 0 to 7, the data for a
+     * frame has the image shifted down by that number of pixels, then the
+     * mask, both one row of bytes taller than the original. The height of
+     * the sprite can't be more than 240.
+     *
+     * The conversion can be done at run time into RAM, or once, for
+     * instance using the host build of the library, to put the resulting
+     * array in program memory.
+     *
+     * If `mask` is `NULL`, `drawPreshifted()` will replace the pixels of the
+     * sprite's rectangle like `drawOverwrite()` does. Passing the image
+     * array as the mask draws like `drawSelfMasked()`.
+     *
+     * \see PRESHIFTED_SPRITE_SIZE() drawPreshifted()
+     */
+    static void preshift(uint8_t *preshifted, const uint8_t *bitmap,
+                         const uint8_t *mask, uint8_t frames);
+
+    /** \brief
+     * Draw a pre-shifted sprite using its image and mask.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the pre-shifted sprite array.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * Bits set to 1 in the mask indicate that the pixel will be set to the
+     * value of the corresponding image bit. Bits set to 0 in the mask will be
+     * left unchanged, as with `drawExternalMask()`.
+     *
+     * \see preshift()
+     */
+    static void drawPreshifted(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
+    /** \brief
+     * Draw a pre-shifted sprite using only the image bits set to 1.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the pre-shifted sprite array.
+     * \param frame The frame number of the image to draw.
+     *
+     * \details
+     * The mask is ignored, as with `drawSelfMasked()`.
+     *
+     * \see preshift()
+     */
+    static void drawPreshiftedSelfMasked(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
+    /** \brief
+     * "Erase" a pre-shifted sprite.
+     *
+     * \param x,y The coordinates of the top left pixel location.
+     * \param sprite A pointer to the pre-shifted sprite array.
+     * \param frame The frame number of the image to erase.
+     *
+     * \details
+     * Image bits set to 1 will set the corresponding pixel in the buffer to
+     * 0, as with `drawErase()`. The mask is ignored.
+     *
+     * \see preshift()
+     */
+    static void drawPreshiftedErase(int16_t x, int16_t y, const uint8_t *sprite, uint8_t frame);
+
     // Master function. Needs to be abstracted into separate function for
     // every render type.
     // (Not officially part of the API)
@@ -230,6 +325,11 @@ class Sprites
     static void drawBitmap(int16_t x, int16_t y,
                            const uint8_t *bitmap, const uint8_t *mask,
                            uint8_t w, uint8_t h, uint8_t draw_mode);
+
+    // (Not officially part of the API)
+    static void drawPreshiftedFrame(int16_t x, int16_t y,
+                                    const uint8_t *sprite, uint8_t frame,
+                                    uint8_t draw_mode);
 };
 
 #endif
@@ -0,0 +1,168 @@
+/**
+ * @file TileMap.cpp
+ * \brief
+ * A class for drawing a scrolling map of 8x8 pixel tiles.
+ */
+
+#include "TileMap.h"
+
+// drawn for the tiles outside of the map
+static const uint8_t emptyTile[8] PROGMEM = { 0 };
+
+TileMap::TileMap(const uint8_t *map, uint8_t width, uint8_t height, const uint8_t *tiles)
+  : map(map), tiles(tiles + 2), width(width), height(height),
+    camX(0), camY(0), lastBuffer(NULL)
+{
+}
+
+void TileMap::setCamera(int16_t x, int16_t y)
+{
+  camX = x;
+  camY = y;
+}
+
+int16_t TileMap::cameraX() const
+{
+  return camX;
+}
+
+int16_t TileMap::cameraY() const
+{
+  return camY;
+}
+
+void TileMap::invalidate()
+{
+  lastBuffer = NULL;
+}
+
+const uint8_t *TileMap::tileAt(int16_t row, int16_t col) const
+{
+  if (row < 0 || row >= height || col < 0 || col >= width) {
+    return emptyTile;
+  }
+  return tiles + pgm_read_byte(map + row * width + col) * 8;
+}
+
+// Whether drawing is neither restricted to part of the display nor moved,
+// so that the map is drawn on the whole display
+static bool wholeDisplay()
+{
+  return MicroGamerBase::clipLeft == 0 && MicroGamerBase::clipRight == WIDTH &&
+         MicroGamerBase::clipTop == 0 && MicroGamerBase::clipBottom == HEIGHT &&
+         MicroGamerBase::originX == 0 && MicroGamerBase::originY == 0;
+}
+
+void TileMap::draw()
+{
+  drawColumns(MicroGamerBase::clipLeft, MicroGamerBase::clipRight);
+
+  // the buffer can only be reused if it now holds the whole map
+  if (wholeDisplay()) {
+    lastBuffer = MicroGamerBase::sBuffer;
+    lastX = camX;
+    lastY = camY;
+  } else {
+    lastBuffer = NULL;
+  }
+}
+
+void TileMap::update()
+{
+  int16_t dx = camX - lastX;
+
+  if (lastBuffer != MicroGamerBase::sBuffer || camY != lastY ||
+      dx <= -WIDTH || dx >= WIDTH || !wholeDisplay()) {
+    draw();
+    return;
+  }
+
+  if (dx != 0) {
+    MicroGamerBase::scroll(-dx, 0);
+
+    // then the columns coming into view
+    if (dx > 0) {
+      drawColumns(WIDTH - dx, WIDTH);
+    } else {
+      drawColumns(0, -dx);
+    }
+    lastX = camX;
+  }
+}
+
+void TileMap::drawColumns(uint8_t x0, uint8_t x1)
+{
+  if (MicroGamerBase::clipBottom <= MicroGamerBase::clipTop) {
+    return;
+  }
+
+  // the map coordinates shown at the top left corner of the display
+  int16_t viewX = camX - MicroGamerBase::originX;
+  int16_t viewY = camY - MicroGamerBase::originY;
+
+  uint8_t firstPage = MicroGamerBase::clipTop / 8;
+  uint8_t pages = (MicroGamerBase::clipBottom + 7) / 8 - firstPage;
+  uint8_t shift = viewY & 7;
+  // the first tile row on the first page, rounded down for negative values
+  int16_t row0 = (viewY - shift) / 8 + firstPage;
+  // the tiles of the current column, one more when they're not page aligned
+  const uint8_t *columnTiles[HEIGHT / 8 + 1];
+  uint8_t rows = pages + (shift != 0 ? 1 : 0);
+  // the rows of the first and last pages within the clip rectangle, the
+  // others being overwritten
+  uint8_t topMask = MicroGamerBase::clipMask(firstPage);
+  uint8_t bottomMask = MicroGamerBase::clipMask(firstPage + pages - 1);
+  bool masked = topMask != 0xFF || bottomMask != 0xFF;
+
+  MicroGamerBase::prepareDrawRect(x0, MicroGamerBase::clipTop, x1 - x0,
+                                  MicroGamerBase::clipBottom - MicroGamerBase::clipTop);
+
+  uint8_t x = x0;
+  while (x < x1) {
+    int16_t mapX = viewX + x;
+    uint8_t tileX = mapX & 7;
+    int16_t col = (mapX - tileX) / 8;
+    // the columns of the display showing the same tiles
+    uint8_t count = 8 - tileX;
+    if (count > x1 - x) {
+      count = x1 - x;
+    }
+
+    for (uint8_t r = 0; r < rows; r++) {
+      columnTiles[r] = tileAt(row0 + r, col) + tileX;
+    }
+
+    for (uint8_t c = 0; c < count; c++) {
+      uint8_t *pBuf = MicroGamerBase::sBuffer + firstPage * WIDTH + x + c;
+
+      uint8_t *pTop = pBuf;
+      uint8_t *pBottom = pBuf + (pages - 1) * WIDTH;
+      uint8_t top = masked ? *pTop : 0;
+      uint8_t bottom = masked ? *pBottom : 0;
+
+      if (shift == 0) {
+        // page aligned: a tile byte for each buffer byte
+        for (uint8_t r = 0; r < rows; r++) {
+          *pBuf = pgm_read_byte(columnTiles[r] + c);
+          pBuf += WIDTH;
+        }
+      } else {
+        // the bottom of a tile above the top of the next one
+        uint16_t column = pgm_read_byte(columnTiles[0] + c);
+        for (uint8_t r = 1; r < rows; r++) {
+          column |= pgm_read_byte(columnTiles[r] + c) << 8;
+          *pBuf = column >> shift;
+          column >>= 8;
+          pBuf += WIDTH;
+        }
+      }
+
+      // the rows outside of the clip rectangle are put back
+      if (masked) {
+        *pBottom = (*pBottom & bottomMask) | (bottom & ~bottomMask);
+        *pTop = (*pTop & topMask) | (top & ~topMask);
+      }
+    }
+    x += count;
+  }
+}
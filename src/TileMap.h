@@ -0,0 +1,131 @@
+/**
+ * @file TileMap.h
+ * \brief
+ * A class for drawing a scrolling map of 8x8 pixel tiles.
+ */
+
+#ifndef TileMap_h
+#define TileMap_h
+
+#include "MicroGamer.h"
+
+/** \brief
+ * A class for drawing a scrolling map of 8x8 pixel tiles.
+ *
+ * \details
+ * A tile map is an array of tile numbers in program memory, one byte per
+ * tile, given row by row from the top left corner of the map. The tiles are
+ * the frames of an 8x8 pixel image in the `Sprites` format: the array begins
+ * with a width and height of 8, followed by 8 bytes for each tile.
+ *
+ * The map is viewed through a camera: the camera position is the map
+ * coordinate, in pixels, of the top left pixel of the display. Anything
+ * outside of the map is drawn as BLACK.
+ *
+ * `draw()` fills the display, or the page being rendered by a strip
+ * renderer, with the visible part of the map. Rather than drawing each tile
+ * as a separate sprite, it goes through the display one column at a time,
+ * looking up the tiles of the column once. When the camera Y coordinate is
+ * a multiple of 8, each byte of a tile is copied to a byte of the buffer,
+ * otherwise each buffer byte is combined from the two tiles it overlaps.
+ *
+ * \see Sprites
+ */
+class TileMap
+{
+ public:
+  /** \brief
+   * Create a tile map.
+   *
+   * \param map A pointer to the array of tile numbers.
+   * \param width,height The size of the map, in tiles.
+   * \param tiles A pointer to the array of 8x8 tile images, in the Sprites
+   * format.
+   */
+  TileMap(const uint8_t *map, uint8_t width, uint8_t height, const uint8_t *tiles);
+
+  /** \brief
+   * Set the position of the camera.
+   *
+   * \param x,y The map coordinates, in pixels, shown at the top left corner
+   * of the display. They can be outside of the map.
+   */
+  void setCamera(int16_t x, int16_t y);
+
+  /** \brief
+   * Get the X coordinate of the camera.
+   *
+   * \return The map X coordinate shown at the left of the display.
+   */
+  int16_t cameraX() const;
+
+  /** \brief
+   * Get the Y coordinate of the camera.
+   *
+   * \return The map Y coordinate shown at the top of the display.
+   */
+  int16_t cameraY() const;
+
+  /** \brief
+   * Draw the visible part of the map.
+   *
+   * \details
+   * The whole display is overwritten with the map, as seen from the camera.
+   * With a strip renderer, only the page being rendered is drawn. When a
+   * clip rectangle is set, only the area inside it is drawn, and the camera
+   * position is shown at the top left corner of the current viewport.
+   *
+   * \see update() MicroGamerBase::pushViewport()
+   */
+  void draw();
+
+  /** \brief
+   * Draw the visible part of the map, reusing the previous frame if
+   * possible.
+   *
+   * \details
+   * If the display buffer still holds the map drawn by the last call of
+   * `draw()` or `update()`, and the camera has only moved horizontally
+   * since, the contents of the buffer are shifted and only the columns
+   * coming into view are drawn. Otherwise the whole map is drawn, as with
+   * `draw()`, which is always the case when a clip rectangle is set.
+   *
+   * This is only correct if nothing else has been drawn over the map in the
+   * buffer since, so it suits sketches that draw the map alone, or that
+   * restore what they draw over it. `invalidate()` must be called when the
+   * buffer has been modified.
+   *
+   * \see draw() invalidate()
+   */
+  void update();
+
+  /** \brief
+   * Forget the contents of the display buffer.
+   *
+   * \details
+   * The next call of `update()` draws the whole map.
+   */
+  void invalidate();
+
+ protected:
+  // Draw the screen columns x0 to x1 - 1, within the clip rows
+  void drawColumns(uint8_t x0, uint8_t x1);
+
+  // Get the image of a tile, or of an empty tile outside of the map
+  const uint8_t *tileAt(int16_t row, int16_t col) const;
+
+  const uint8_t *map;
+  const uint8_t *tiles;
+  uint8_t width;
+  uint8_t height;
+  int16_t camX;
+  int16_t camY;
+
+  // the buffer holding the map as seen from the last camera position, or
+  // NULL if there is none
+  uint8_t *lastBuffer;
+  int16_t lastX;
+  int16_t lastY;
+};
+
+#endif